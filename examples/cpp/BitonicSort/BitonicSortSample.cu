@@ -1,4 +1,5 @@
 #include "BitonicSortSample.h"
+#include "../../../src/cpp/NearestNeighbor.h"
 #include "../../../src/cpp/Point.h"
 #include "../../../src/cuda/BitonicSort.h"
 
@@ -9,13 +10,15 @@
 
 #define BLOCK_SIZE 32 // ToDo
 
-SignalScatter::BitonicSortSample::BitonicSortSample(uint32_t size)
+SignalScatter::BitonicSortSample::BitonicSortSample(uint32_t size, uint32_t nearestCount, float maxDistance)
 {
     std::random_device seed_gen;
     std::default_random_engine engine(seed_gen());
     std::uniform_real_distribution<float> dist(-256, 256);
 
     _size = size;
+    _nearestCount = nearestCount;
+    _maxDistance = maxDistance;
 
     _distanceMatrix = new float[size * size];
     _distanceMatrixMemorySize = size * size * sizeof(float);
@@ -23,6 +26,11 @@ SignalScatter::BitonicSortSample::BitonicSortSample(uint32_t size)
     _packedIdMatrix = new uint32_t[size * size];
     _packedIdMatrixMemorySize = size * size * sizeof(uint32_t);
 
+    _nearestDistanceMatrix = new float[size * nearestCount];
+    _nearestIdMatrix = new uint32_t[size * nearestCount];
+
+    _compactRowOffsets = new uint32_t[size + 1];
+
     _points = new Point[size];
     _pointListMemorySize = size * sizeof(Point);
 
@@ -40,6 +48,8 @@ SignalScatter::BitonicSortSample::BitonicSortSample(uint32_t size)
     std::cout << "----------" << std::endl;
     std::cout << "N: " << _size << std::endl;
     std::cout << "N x N: " << (_size * _size) << std::endl;
+    std::cout << "K: " << _nearestCount << std::endl;
+    std::cout << "MaxDistance: " << _maxDistance << std::endl;
     std::cout << "PointListMemorySize: " << _pointListMemorySize << " [Bytes]" << std::endl;
     std::cout << "DistanceMatrixMemorySize: " << _distanceMatrixMemorySize << " [Bytes]" << std::endl;
     std::cout << "PackedIdMatrixMemorySize: " << _packedIdMatrixMemorySize << " [Bytes]" << std::endl;
@@ -81,6 +91,10 @@ SignalScatter::BitonicSortSample::~BitonicSortSample()
 
     err = cudaFree(_d_PackedIdMatrixOut);
     std::cout << "CudaFree: " << err << std::endl;
+
+    delete[] _nearestDistanceMatrix;
+    delete[] _nearestIdMatrix;
+    delete[] _compactRowOffsets;
 }
 
 __global__ void CalculateDistanceKernel(int n, SignalScatter::Point *points, 
@@ -151,6 +165,24 @@ void PrintDistanceMatrix(std::string title, uint32_t size, float *distanceMatrix
     std::cout << "-----" << std::endl;
 }
 
+void PrintNearestMatrix(std::string title, uint32_t size, uint32_t k, float *nearestDistanceMatrix, uint32_t *nearestIdMatrix)
+{
+    std::cout << "-----" << std::endl;
+    std::cout << title << std::endl;
+    std::cout << "-----" << std::endl;
+    for (int i = 0; i < size; i++)
+    {
+        for (int j = 0; j < k; j++)
+        {
+            int pi = (nearestIdMatrix[i*k + j] & 0xFFFF0000) >> 16;
+            int pj = nearestIdMatrix[i*k + j] & 0xFFFF;
+            std::cout << "N[" << i << "][" << j << "]: " << nearestDistanceMatrix[i*k + j] << " (" << pi << ", " << pj << ")" << std::endl;
+        }
+        std::cout << "-----" << std::endl;
+    }
+    std::cout << "-----" << std::endl;
+}
+
 void SignalScatter::BitonicSortSample::Run()
 {
     cudaError_t err;
@@ -189,6 +221,48 @@ void SignalScatter::BitonicSortSample::Run()
 
     PrintDistanceMatrix("Before BitonicSort", _size, _distanceMatrix, _packedIdMatrix);
 
+    std::cout << "----------" << std::endl;
+    std::cout << "Nearest Neighbor Selection on Host" << std::endl;
+    std::cout << "----------" << std::endl;
+
+    start = std::chrono::system_clock::now();
+
+    std::cout << "Start SelectNearest" << std::endl;
+    SelectNearest(_size, _size, _nearestCount, _distanceMatrix, _packedIdMatrix, _nearestDistanceMatrix, _nearestIdMatrix);
+
+    end = std::chrono::system_clock::now();
+    elapsedTimeMilliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "----------" << std::endl;
+    std::cout << "Elapsed time: " << elapsedTimeMilliseconds << " [ms]" << std::endl;
+    std::cout << "----------" << std::endl;
+
+    PrintNearestMatrix("SelectNearest", _size, _nearestCount, _nearestDistanceMatrix, _nearestIdMatrix);
+
+    std::cout << "----------" << std::endl;
+    std::cout << "Radius Cut-off and Segment Sort on Host" << std::endl;
+    std::cout << "----------" << std::endl;
+
+    start = std::chrono::system_clock::now();
+
+    std::cout << "Start CompactWithinDistance" << std::endl;
+    uint32_t compactLength = CountWithinDistance(_size, _size, _maxDistance, _distanceMatrix, _compactRowOffsets);
+    float *compactDistances = new float[compactLength];
+    uint32_t *compactIds = new uint32_t[compactLength];
+    CompactWithinDistance(_size, _size, _maxDistance, _distanceMatrix, _packedIdMatrix, _compactRowOffsets, compactDistances, compactIds);
+
+    std::cout << "Start SortSegments" << std::endl;
+    SortSegments(_size, _compactRowOffsets, compactDistances, compactIds);
+
+    end = std::chrono::system_clock::now();
+    elapsedTimeMilliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::cout << "----------" << std::endl;
+    std::cout << "Survivors: " << compactLength << " / " << (_size * _size) << std::endl;
+    std::cout << "Elapsed time: " << elapsedTimeMilliseconds << " [ms]" << std::endl;
+    std::cout << "----------" << std::endl;
+
+    delete[] compactDistances;
+    delete[] compactIds;
+
     start = std::chrono::system_clock::now();
 
     uint ascending = 1;
@@ -9,12 +9,14 @@ namespace SignalScatter
     class BitonicSortSample
     {
         public:
-            BitonicSortSample(uint32_t size);
+            BitonicSortSample(uint32_t size, uint32_t nearestCount = 4, float maxDistance = 128);
             ~BitonicSortSample();
             void Run();
 
         private:
             uint32_t _size;
+            uint32_t _nearestCount;
+            float _maxDistance;
 
             Point* _points;
             Point *_d_PointList;
@@ -22,6 +24,11 @@ namespace SignalScatter
             float *_distanceMatrix;
             uint32_t *_packedIdMatrix;
 
+            float *_nearestDistanceMatrix;
+            uint32_t *_nearestIdMatrix;
+
+            uint32_t *_compactRowOffsets;
+
             float *_d_DistanceMatrixOut;
             uint32_t *_d_PackedIdMatrixOut;
 
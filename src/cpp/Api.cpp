@@ -6,7 +6,11 @@
 #define EXPORT_API
 #endif
 
+#include "ConcurrentRingBuffer.h"
 #include "RingBuffer.h"
+#include "RingGroup.h"
+#include "RingPool.h"
+#include "ScatterEngine.h"
 #include "Span.h"
 
 extern "C"
@@ -48,4 +52,451 @@ EXPORT_API bool ring_buffer_try_bulk_dequeue(SignalScatter::RingBuffer* ringBuff
     return ringBuffer->TryBulkDequeue(span);
 }
 
-}
\ No newline at end of file
+EXPORT_API void ring_buffer_clear(SignalScatter::RingBuffer* ringBuffer)
+{
+    ringBuffer->Clear();
+}
+
+EXPORT_API void ring_buffer_clear_length(SignalScatter::RingBuffer* ringBuffer, int length)
+{
+    ringBuffer->Clear(length);
+}
+
+EXPORT_API void ring_buffer_slice(SignalScatter::RingBuffer* ringBuffer, int start, int length, SignalScatter::ByteSpan* firstSegment, SignalScatter::ByteSpan* secondSegment)
+{
+    ringBuffer->Slice(start, length, *firstSegment, *secondSegment);
+}
+
+EXPORT_API bool ring_buffer_try_bulk_enqueue_byte4(SignalScatter::RingBuffer* ringBuffer, uint8_t* pointer)
+{
+    SignalScatter::ByteSpan span(pointer, 4);
+    return ringBuffer->TryBulkEnqueueByte4(span);
+}
+
+EXPORT_API bool ring_buffer_try_bulk_enqueue_byte8(SignalScatter::RingBuffer* ringBuffer, uint8_t* pointer)
+{
+    SignalScatter::ByteSpan span(pointer, 8);
+    return ringBuffer->TryBulkEnqueueByte8(span);
+}
+
+EXPORT_API bool ring_buffer_try_bulk_enqueue_byte16(SignalScatter::RingBuffer* ringBuffer, uint8_t* pointer)
+{
+    SignalScatter::ByteSpan span(pointer, 16);
+    return ringBuffer->TryBulkEnqueueByte16(span);
+}
+
+EXPORT_API bool ring_buffer_try_bulk_enqueue_byte32(SignalScatter::RingBuffer* ringBuffer, uint8_t* pointer)
+{
+    SignalScatter::ByteSpan span(pointer, 32);
+    return ringBuffer->TryBulkEnqueueByte32(span);
+}
+
+EXPORT_API bool ring_buffer_try_bulk_dequeue_byte4(SignalScatter::RingBuffer* ringBuffer, uint8_t* pointer)
+{
+    SignalScatter::ByteSpan span(pointer, 4);
+    return ringBuffer->TryBulkDequeueByte4(span);
+}
+
+EXPORT_API bool ring_buffer_try_bulk_dequeue_byte8(SignalScatter::RingBuffer* ringBuffer, uint8_t* pointer)
+{
+    SignalScatter::ByteSpan span(pointer, 8);
+    return ringBuffer->TryBulkDequeueByte8(span);
+}
+
+EXPORT_API bool ring_buffer_try_bulk_dequeue_byte16(SignalScatter::RingBuffer* ringBuffer, uint8_t* pointer)
+{
+    SignalScatter::ByteSpan span(pointer, 16);
+    return ringBuffer->TryBulkDequeueByte16(span);
+}
+
+EXPORT_API bool ring_buffer_try_bulk_dequeue_byte32(SignalScatter::RingBuffer* ringBuffer, uint8_t* pointer)
+{
+    SignalScatter::ByteSpan span(pointer, 32);
+    return ringBuffer->TryBulkDequeueByte32(span);
+}
+
+EXPORT_API int ring_buffer_acquire_read(SignalScatter::RingBuffer* ringBuffer, int maxLength, SignalScatter::ByteSpan* firstSegment, SignalScatter::ByteSpan* secondSegment, int* token)
+{
+    return ringBuffer->Acquire(maxLength, *firstSegment, *secondSegment, *token);
+}
+
+EXPORT_API void ring_buffer_release_read(SignalScatter::RingBuffer* ringBuffer, int token, int length)
+{
+    ringBuffer->Release(token, length);
+}
+
+EXPORT_API bool ring_buffer_reserve_write(SignalScatter::RingBuffer* ringBuffer, int length, SignalScatter::ByteSpan* firstSegment, SignalScatter::ByteSpan* secondSegment)
+{
+    return ringBuffer->TryReserve(length, *firstSegment, *secondSegment);
+}
+
+EXPORT_API void ring_buffer_commit_write(SignalScatter::RingBuffer* ringBuffer, int length)
+{
+    ringBuffer->Commit(length);
+}
+
+EXPORT_API int ring_buffer_enqueue_batch(SignalScatter::RingBuffer* ringBuffer, SignalScatter::ByteSpan const* spans, int spanCount)
+{
+    return ringBuffer->EnqueueBatch(spans, spanCount);
+}
+
+EXPORT_API int ring_buffer_dequeue_batch(SignalScatter::RingBuffer* ringBuffer, uint8_t* destination, int recordSize, int maxRecordCount)
+{
+    return ringBuffer->DequeueBatch(destination, recordSize, maxRecordCount);
+}
+
+EXPORT_API int ring_buffer_enqueue_from_fd(SignalScatter::RingBuffer* ringBuffer, int fd, int maxBytes)
+{
+    return ringBuffer->EnqueueFromFd(fd, maxBytes);
+}
+
+EXPORT_API int ring_buffer_dequeue_to_fd(SignalScatter::RingBuffer* ringBuffer, int fd, int maxBytes)
+{
+    return ringBuffer->DequeueToFd(fd, maxBytes);
+}
+
+//////////////////////////////
+///  ConcurrentRingBuffer  ///
+//////////////////////////////
+
+EXPORT_API SignalScatter::ConcurrentRingBuffer* create_concurrent_ring_buffer(int capacity)
+{
+    return new SignalScatter::ConcurrentRingBuffer(capacity);
+}
+
+EXPORT_API void release_concurrent_ring_buffer(SignalScatter::ConcurrentRingBuffer* ringBuffer)
+{
+    delete ringBuffer;
+}
+
+EXPORT_API int concurrent_ring_buffer_get_buffer_size(SignalScatter::ConcurrentRingBuffer* ringBuffer)
+{
+    return ringBuffer->GetBufferSize();
+}
+
+EXPORT_API int concurrent_ring_buffer_get_count(SignalScatter::ConcurrentRingBuffer* ringBuffer)
+{
+    return ringBuffer->GetCount();
+}
+
+EXPORT_API bool concurrent_ring_buffer_try_bulk_enqueue(SignalScatter::ConcurrentRingBuffer* ringBuffer, uint8_t* pointer, int length)
+{
+    SignalScatter::ByteSpan span(pointer, length);
+    return ringBuffer->TryBulkEnqueue(span);
+}
+
+EXPORT_API bool concurrent_ring_buffer_try_bulk_dequeue(SignalScatter::ConcurrentRingBuffer* ringBuffer, uint8_t* pointer, int length)
+{
+    SignalScatter::ByteSpan span(pointer, length);
+    return ringBuffer->TryBulkDequeue(span);
+}
+
+EXPORT_API uint8_t concurrent_ring_buffer_get_value(SignalScatter::ConcurrentRingBuffer* ringBuffer, int index)
+{
+    return ringBuffer->GetValue(index);
+}
+
+EXPORT_API uint8_t concurrent_ring_buffer_get_head_value(SignalScatter::ConcurrentRingBuffer* ringBuffer)
+{
+    return ringBuffer->GetHeadValue();
+}
+
+EXPORT_API void concurrent_ring_buffer_clear(SignalScatter::ConcurrentRingBuffer* ringBuffer)
+{
+    ringBuffer->Clear();
+}
+
+EXPORT_API void concurrent_ring_buffer_clear_length(SignalScatter::ConcurrentRingBuffer* ringBuffer, int length)
+{
+    ringBuffer->Clear(length);
+}
+
+EXPORT_API void concurrent_ring_buffer_slice(SignalScatter::ConcurrentRingBuffer* ringBuffer, int start, int length, SignalScatter::ByteSpan* firstSegment, SignalScatter::ByteSpan* secondSegment)
+{
+    ringBuffer->Slice(start, length, *firstSegment, *secondSegment);
+}
+
+EXPORT_API bool concurrent_ring_buffer_try_bulk_enqueue_byte4(SignalScatter::ConcurrentRingBuffer* ringBuffer, uint8_t* pointer)
+{
+    SignalScatter::ByteSpan span(pointer, 4);
+    return ringBuffer->TryBulkEnqueueByte4(span);
+}
+
+EXPORT_API bool concurrent_ring_buffer_try_bulk_enqueue_byte8(SignalScatter::ConcurrentRingBuffer* ringBuffer, uint8_t* pointer)
+{
+    SignalScatter::ByteSpan span(pointer, 8);
+    return ringBuffer->TryBulkEnqueueByte8(span);
+}
+
+EXPORT_API bool concurrent_ring_buffer_try_bulk_enqueue_byte16(SignalScatter::ConcurrentRingBuffer* ringBuffer, uint8_t* pointer)
+{
+    SignalScatter::ByteSpan span(pointer, 16);
+    return ringBuffer->TryBulkEnqueueByte16(span);
+}
+
+EXPORT_API bool concurrent_ring_buffer_try_bulk_enqueue_byte32(SignalScatter::ConcurrentRingBuffer* ringBuffer, uint8_t* pointer)
+{
+    SignalScatter::ByteSpan span(pointer, 32);
+    return ringBuffer->TryBulkEnqueueByte32(span);
+}
+
+EXPORT_API bool concurrent_ring_buffer_try_bulk_dequeue_byte4(SignalScatter::ConcurrentRingBuffer* ringBuffer, uint8_t* pointer)
+{
+    SignalScatter::ByteSpan span(pointer, 4);
+    return ringBuffer->TryBulkDequeueByte4(span);
+}
+
+EXPORT_API bool concurrent_ring_buffer_try_bulk_dequeue_byte8(SignalScatter::ConcurrentRingBuffer* ringBuffer, uint8_t* pointer)
+{
+    SignalScatter::ByteSpan span(pointer, 8);
+    return ringBuffer->TryBulkDequeueByte8(span);
+}
+
+EXPORT_API bool concurrent_ring_buffer_try_bulk_dequeue_byte16(SignalScatter::ConcurrentRingBuffer* ringBuffer, uint8_t* pointer)
+{
+    SignalScatter::ByteSpan span(pointer, 16);
+    return ringBuffer->TryBulkDequeueByte16(span);
+}
+
+EXPORT_API bool concurrent_ring_buffer_try_bulk_dequeue_byte32(SignalScatter::ConcurrentRingBuffer* ringBuffer, uint8_t* pointer)
+{
+    SignalScatter::ByteSpan span(pointer, 32);
+    return ringBuffer->TryBulkDequeueByte32(span);
+}
+
+EXPORT_API int concurrent_ring_buffer_acquire_read(SignalScatter::ConcurrentRingBuffer* ringBuffer, int maxLength, int recordSize, SignalScatter::ByteSpan* firstSegment, SignalScatter::ByteSpan* secondSegment, int* token)
+{
+    return ringBuffer->Acquire(maxLength, recordSize, *firstSegment, *secondSegment, *token);
+}
+
+EXPORT_API void concurrent_ring_buffer_release_read(SignalScatter::ConcurrentRingBuffer* ringBuffer, int token, int length)
+{
+    ringBuffer->Release(token, length);
+}
+
+EXPORT_API bool concurrent_ring_buffer_reserve_write(SignalScatter::ConcurrentRingBuffer* ringBuffer, int length, SignalScatter::ByteSpan* firstSegment, SignalScatter::ByteSpan* secondSegment, int* token)
+{
+    return ringBuffer->TryReserve(length, *firstSegment, *secondSegment, *token);
+}
+
+EXPORT_API void concurrent_ring_buffer_commit_write(SignalScatter::ConcurrentRingBuffer* ringBuffer, int token, int length)
+{
+    ringBuffer->Commit(token, length);
+}
+
+EXPORT_API int concurrent_ring_buffer_enqueue_batch(SignalScatter::ConcurrentRingBuffer* ringBuffer, SignalScatter::ByteSpan const* spans, int spanCount)
+{
+    return ringBuffer->EnqueueBatch(spans, spanCount);
+}
+
+EXPORT_API int concurrent_ring_buffer_dequeue_batch(SignalScatter::ConcurrentRingBuffer* ringBuffer, uint8_t* destination, int recordSize, int maxRecordCount)
+{
+    return ringBuffer->DequeueBatch(destination, recordSize, maxRecordCount);
+}
+
+EXPORT_API int concurrent_ring_buffer_enqueue_from_fd(SignalScatter::ConcurrentRingBuffer* ringBuffer, int fd, int maxBytes)
+{
+    return ringBuffer->EnqueueFromFd(fd, maxBytes);
+}
+
+EXPORT_API int concurrent_ring_buffer_dequeue_to_fd(SignalScatter::ConcurrentRingBuffer* ringBuffer, int fd, int maxBytes)
+{
+    return ringBuffer->DequeueToFd(fd, maxBytes);
+}
+
+EXPORT_API int concurrent_ring_buffer_enable_readable_event(SignalScatter::ConcurrentRingBuffer* ringBuffer)
+{
+    return ringBuffer->EnableReadableEvent();
+}
+
+EXPORT_API int concurrent_ring_buffer_enable_writable_event(SignalScatter::ConcurrentRingBuffer* ringBuffer, int lowWatermark)
+{
+    return ringBuffer->EnableWritableEvent(lowWatermark);
+}
+
+EXPORT_API bool concurrent_ring_buffer_arm_readable_event(SignalScatter::ConcurrentRingBuffer* ringBuffer)
+{
+    return ringBuffer->ArmReadableEvent();
+}
+
+EXPORT_API bool concurrent_ring_buffer_arm_writable_event(SignalScatter::ConcurrentRingBuffer* ringBuffer)
+{
+    return ringBuffer->ArmWritableEvent();
+}
+
+EXPORT_API bool concurrent_ring_buffer_wait_readable(SignalScatter::ConcurrentRingBuffer* ringBuffer, int timeoutMilliseconds)
+{
+    return ringBuffer->WaitReadable(timeoutMilliseconds);
+}
+
+EXPORT_API bool concurrent_ring_buffer_wait_writable(SignalScatter::ConcurrentRingBuffer* ringBuffer, int timeoutMilliseconds)
+{
+    return ringBuffer->WaitWritable(timeoutMilliseconds);
+}
+
+///////////////////
+///  RingGroup  ///
+///////////////////
+
+EXPORT_API SignalScatter::RingGroup* create_ring_group(int capacity)
+{
+    return new SignalScatter::RingGroup(capacity);
+}
+
+EXPORT_API void release_ring_group(SignalScatter::RingGroup* ringGroup)
+{
+    delete ringGroup;
+}
+
+EXPORT_API int ring_group_get_member_count(SignalScatter::RingGroup* ringGroup)
+{
+    return ringGroup->GetMemberCount();
+}
+
+EXPORT_API int ring_group_add(SignalScatter::RingGroup* ringGroup, SignalScatter::ConcurrentRingBuffer* ringBuffer)
+{
+    return ringGroup->Add(ringBuffer);
+}
+
+EXPORT_API void ring_group_remove(SignalScatter::RingGroup* ringGroup, int member)
+{
+    ringGroup->Remove(member);
+}
+
+EXPORT_API int ring_group_poll(SignalScatter::RingGroup* ringGroup, int* members, int maxCount)
+{
+    return ringGroup->Poll(members, maxCount);
+}
+
+EXPORT_API int ring_group_drain(SignalScatter::RingGroup* ringGroup, int budgetPerRing, int recordSize, uint8_t* buffer, int bufferSize,
+                                int* members, int* lengths, int maxEntryCount)
+{
+    return ringGroup->Drain(budgetPerRing, recordSize, buffer, bufferSize, members, lengths, maxEntryCount);
+}
+
+//////////////////
+///  RingPool  ///
+//////////////////
+
+EXPORT_API SignalScatter::RingPool* create_ring_pool(int maxRingCount)
+{
+    return new SignalScatter::RingPool(maxRingCount);
+}
+
+EXPORT_API void release_ring_pool(SignalScatter::RingPool* ringPool)
+{
+    delete ringPool;
+}
+
+EXPORT_API int ring_pool_preallocate(SignalScatter::RingPool* ringPool, int capacity, int count, bool concurrent)
+{
+    return ringPool->Preallocate(capacity, count, concurrent);
+}
+
+EXPORT_API int64_t ring_pool_acquire(SignalScatter::RingPool* ringPool, int capacity)
+{
+    return ringPool->Acquire(capacity);
+}
+
+EXPORT_API int64_t ring_pool_acquire_concurrent(SignalScatter::RingPool* ringPool, int capacity)
+{
+    return ringPool->AcquireConcurrent(capacity);
+}
+
+EXPORT_API void ring_pool_release(SignalScatter::RingPool* ringPool, int64_t handle)
+{
+    ringPool->Release(handle);
+}
+
+// The ring objects can be used with the ring_buffer_* / concurrent_ring_buffer_* functions until the handle is released.
+EXPORT_API SignalScatter::RingBuffer* ring_pool_get_ring_buffer(SignalScatter::RingPool* ringPool, int64_t handle)
+{
+    return ringPool->GetRingBuffer(handle);
+}
+
+EXPORT_API SignalScatter::ConcurrentRingBuffer* ring_pool_get_concurrent_ring_buffer(SignalScatter::RingPool* ringPool, int64_t handle)
+{
+    return ringPool->GetConcurrentRingBuffer(handle);
+}
+
+// Handle-checked shortcuts for either kind of ring; stale handles behave like an empty, full ring.
+EXPORT_API int ring_pool_get_count(SignalScatter::RingPool* ringPool, int64_t handle)
+{
+    if (SignalScatter::RingBuffer* ringBuffer = ringPool->GetRingBuffer(handle)) { return ringBuffer->GetCount(); }
+    if (SignalScatter::ConcurrentRingBuffer* ringBuffer = ringPool->GetConcurrentRingBuffer(handle)) { return ringBuffer->GetCount(); }
+    return 0;
+}
+
+EXPORT_API bool ring_pool_try_bulk_enqueue(SignalScatter::RingPool* ringPool, int64_t handle, uint8_t* pointer, int length)
+{
+    SignalScatter::ByteSpan span(pointer, length);
+    if (SignalScatter::RingBuffer* ringBuffer = ringPool->GetRingBuffer(handle)) { return ringBuffer->TryBulkEnqueue(span); }
+    if (SignalScatter::ConcurrentRingBuffer* ringBuffer = ringPool->GetConcurrentRingBuffer(handle)) { return ringBuffer->TryBulkEnqueue(span); }
+    return false;
+}
+
+EXPORT_API bool ring_pool_try_bulk_dequeue(SignalScatter::RingPool* ringPool, int64_t handle, uint8_t* pointer, int length)
+{
+    SignalScatter::ByteSpan span(pointer, length);
+    if (SignalScatter::RingBuffer* ringBuffer = ringPool->GetRingBuffer(handle))
+    {
+        return ringBuffer->GetCount() >= length && ringBuffer->TryBulkDequeue(span);
+    }
+    if (SignalScatter::ConcurrentRingBuffer* ringBuffer = ringPool->GetConcurrentRingBuffer(handle))
+    {
+        return ringBuffer->GetCount() >= length && ringBuffer->TryBulkDequeue(span);
+    }
+    return false;
+}
+
+///////////////////////
+///  ScatterEngine  ///
+///////////////////////
+
+EXPORT_API SignalScatter::ScatterEngine* create_scatter_engine(uint32_t pointCount, int inboxCapacity, uint32_t arenaSize, uint32_t maxMessageCount)
+{
+    return new SignalScatter::ScatterEngine(pointCount, inboxCapacity, arenaSize, maxMessageCount);
+}
+
+EXPORT_API void release_scatter_engine(SignalScatter::ScatterEngine* engine)
+{
+    delete engine;
+}
+
+EXPORT_API bool scatter_engine_publish(SignalScatter::ScatterEngine* engine, uint32_t source, uint8_t* pointer, int length)
+{
+    SignalScatter::ByteSpan span(pointer, length);
+    return engine->Publish(source, span);
+}
+
+EXPORT_API uint32_t scatter_engine_scatter(SignalScatter::ScatterEngine* engine, uint32_t k, uint32_t* neighborIdMatrix)
+{
+    return engine->Scatter(k, neighborIdMatrix);
+}
+
+EXPORT_API uint32_t scatter_engine_scatter_csr(SignalScatter::ScatterEngine* engine, uint32_t* neighborOffsets, uint32_t* neighborIds)
+{
+    return engine->Scatter(neighborOffsets, neighborIds);
+}
+
+EXPORT_API uint32_t scatter_engine_get_dropped_count(SignalScatter::ScatterEngine* engine)
+{
+    return engine->GetDroppedCount();
+}
+
+EXPORT_API bool scatter_engine_try_receive(SignalScatter::ScatterEngine* engine, uint32_t point, uint8_t** pointer, int* length)
+{
+    SignalScatter::ByteSpan span;
+    if (!engine->TryReceive(point, span)) { return false; }
+
+    *pointer = span.Pointer;
+    *length = span.Length;
+    return true;
+}
+
+EXPORT_API void scatter_engine_reset_frame(SignalScatter::ScatterEngine* engine)
+{
+    engine->ResetFrame();
+}
+
+}
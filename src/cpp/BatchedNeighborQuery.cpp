@@ -0,0 +1,216 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#include "BatchedNeighborQuery.h"
+#include "NeighborHeap.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Target number of pair evaluations per work item.
+#define WORK_ITEM_COST 16384
+
+SignalScatter::BatchedNeighborQuery::BatchedNeighborQuery()
+{
+    _maxSceneSize = 0;
+}
+
+SignalScatter::BatchedNeighborQuery::~BatchedNeighborQuery()
+{
+}
+
+uint32_t const* SignalScatter::BatchedNeighborQuery::GetNeighborOffsets()
+{
+    return _neighborOffsets.data();
+}
+
+float const* SignalScatter::BatchedNeighborQuery::GetNeighborDistances()
+{
+    return _neighborDistances.data();
+}
+
+uint32_t const* SignalScatter::BatchedNeighborQuery::GetNeighborIds()
+{
+    return _neighborIds.data();
+}
+
+void SignalScatter::BatchedNeighborQuery::Prepare(Point const* points, uint32_t const* sceneOffsets, uint32_t sceneCount)
+{
+    uint32_t count = sceneOffsets[sceneCount];
+
+    _positionX.resize(count);
+    _positionY.resize(count);
+    _positionZ.resize(count);
+    _ids.resize(count);
+
+    ThreadPool::GetDefault().ParallelFor(0, count, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int64_t i = rangeBegin; i < rangeEnd; i++)
+        {
+            _positionX[i] = points[i].PositionX;
+            _positionY[i] = points[i].PositionY;
+            _positionZ[i] = points[i].PositionZ;
+            _ids[i] = points[i].Id;
+        }
+    });
+
+    _workItems.clear();
+    _maxSceneSize = 0;
+
+    for (uint32_t scene = 0; scene < sceneCount; scene++)
+    {
+        uint32_t sceneBegin = sceneOffsets[scene];
+        uint32_t sceneEnd = sceneOffsets[scene + 1];
+        uint32_t sceneSize = sceneEnd - sceneBegin;
+        if (sceneSize == 0) { continue; }
+
+        _maxSceneSize = std::max(_maxSceneSize, sceneSize);
+
+        // Large scenes are split into row ranges so that each item costs about WORK_ITEM_COST.
+        uint32_t rowsPerItem = std::max(1u, (uint32_t)(WORK_ITEM_COST / sceneSize));
+        for (uint32_t rowBegin = sceneBegin; rowBegin < sceneEnd; rowBegin += rowsPerItem)
+        {
+            WorkItem item;
+            item.SceneBegin = sceneBegin;
+            item.SceneEnd = sceneEnd;
+            item.RowBegin = rowBegin;
+            item.RowEnd = std::min(rowBegin + rowsPerItem, sceneEnd);
+            item.Cost = (uint64_t)(item.RowEnd - item.RowBegin) * sceneSize;
+            _workItems.push_back(item);
+        }
+    }
+
+    // Largest items first; the small tail then fills the gaps between threads.
+    std::stable_sort(_workItems.begin(), _workItems.end(),
+        [](WorkItem const& a, WorkItem const& b) { return a.Cost > b.Cost; });
+}
+
+void SignalScatter::BatchedNeighborQuery::CalculateRow(uint32_t row, uint32_t sceneBegin, uint32_t sceneEnd, float* distances)
+{
+    float ax = _positionX[row];
+    float ay = _positionY[row];
+    float az = _positionZ[row];
+    float const* x = _positionX.data() + sceneBegin;
+    float const* y = _positionY.data() + sceneBegin;
+    float const* z = _positionZ.data() + sceneBegin;
+    uint32_t sceneSize = sceneEnd - sceneBegin;
+
+    for (uint32_t column = 0; column < sceneSize; column++)
+    {
+        float dx = ax - x[column];
+        float dy = ay - y[column];
+        float dz = az - z[column];
+        distances[column] = dx * dx + dy * dy + dz * dz; // Squared Distance
+    }
+}
+
+void SignalScatter::BatchedNeighborQuery::QueryNearest(Point const* points, uint32_t const* sceneOffsets, uint32_t sceneCount,
+                                                       uint32_t k, float* nearestDistanceMatrix, uint32_t* nearestIdMatrix)
+{
+    if (k == 0) { return; }
+
+    Prepare(points, sceneOffsets, sceneCount);
+
+    int64_t workItemCount = (int64_t)_workItems.size();
+
+    ThreadPool::GetDefault().ParallelFor(0, workItemCount, 1, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        std::vector<float> distances(_maxSceneSize);
+        std::vector<float> heapDistances(k);
+        std::vector<uint32_t> heapIds(k);
+        NeighborHeap heap(heapDistances.data(), heapIds.data(), (int)k);
+
+        for (int64_t i = rangeBegin; i < rangeEnd; i++)
+        {
+            WorkItem const& item = _workItems[i];
+
+            for (uint32_t row = item.RowBegin; row < item.RowEnd; row++)
+            {
+                CalculateRow(row, item.SceneBegin, item.SceneEnd, distances.data());
+                heap.PushRange(distances.data(), _ids.data() + item.SceneBegin, item.SceneEnd - item.SceneBegin);
+                heap.Sort(nearestDistanceMatrix + (size_t)row * k, nearestIdMatrix + (size_t)row * k);
+            }
+        }
+    });
+}
+
+void SignalScatter::BatchedNeighborQuery::QueryRadius(Point const* points, uint32_t const* sceneOffsets, uint32_t sceneCount,
+                                                      float radius, bool sorted)
+{
+    Prepare(points, sceneOffsets, sceneCount);
+
+    uint32_t count = sceneOffsets[sceneCount];
+    int64_t workItemCount = (int64_t)_workItems.size();
+    float squaredRadius = radius * radius;
+
+    _neighborOffsets.assign(count + 1, 0);
+
+    // Count pass, prefix sum, then fill pass straight into the CSR arrays.
+    for (int pass = 0; pass < 2; pass++)
+    {
+        if (pass == 1)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                _neighborOffsets[i + 1] += _neighborOffsets[i];
+            }
+            _neighborDistances.resize(_neighborOffsets[count]);
+            _neighborIds.resize(_neighborOffsets[count]);
+        }
+
+        ThreadPool::GetDefault().ParallelFor(0, workItemCount, 1, [&](int64_t rangeBegin, int64_t rangeEnd)
+        {
+            std::vector<float> distances(_maxSceneSize);
+            std::vector<std::pair<float, uint32_t>> pairs;
+
+            for (int64_t i = rangeBegin; i < rangeEnd; i++)
+            {
+                WorkItem const& item = _workItems[i];
+                uint32_t sceneSize = item.SceneEnd - item.SceneBegin;
+
+                for (uint32_t row = item.RowBegin; row < item.RowEnd; row++)
+                {
+                    CalculateRow(row, item.SceneBegin, item.SceneEnd, distances.data());
+
+                    if (pass == 0)
+                    {
+                        uint32_t found = 0;
+                        for (uint32_t column = 0; column < sceneSize; column++)
+                        {
+                            found += (distances[column] <= squaredRadius);
+                        }
+                        _neighborOffsets[row + 1] = found;
+                        continue;
+                    }
+
+                    uint32_t begin = _neighborOffsets[row];
+                    uint32_t cursor = begin;
+                    for (uint32_t column = 0; column < sceneSize; column++)
+                    {
+                        if (distances[column] <= squaredRadius)
+                        {
+                            _neighborDistances[cursor] = distances[column];
+                            _neighborIds[cursor] = _ids[item.SceneBegin + column];
+                            cursor++;
+                        }
+                    }
+
+                    if (sorted)
+                    {
+                        pairs.resize(cursor - begin);
+                        for (uint32_t j = begin; j < cursor; j++) { pairs[j - begin] = std::make_pair(_neighborDistances[j], _neighborIds[j]); }
+                        std::sort(pairs.begin(), pairs.end());
+                        for (uint32_t j = begin; j < cursor; j++)
+                        {
+                            _neighborDistances[j] = pairs[j - begin].first;
+                            _neighborIds[j] = pairs[j - begin].second;
+                        }
+                    }
+                }
+            }
+        });
+    }
+}
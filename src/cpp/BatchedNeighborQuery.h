@@ -0,0 +1,59 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "Point.h"
+#include <cstdint>
+#include <vector>
+
+namespace SignalScatter
+{
+    // Runs neighbor queries for many independent scenes in one parallel pass.
+    // Scenes are given in CSR form: scene s owns points [sceneOffsets[s], sceneOffsets[s + 1]) of one
+    // point array, and neighbors are only searched within the same scene. Work is split into
+    // (scene, row range) items of similar cost and handed out largest first, so a few large scenes
+    // do not serialize behind many small ones. Results are indexed by the global point position.
+    class BatchedNeighborQuery
+    {
+    public:
+        BatchedNeighborQuery();
+        ~BatchedNeighborQuery();
+
+        // count x k matrices, where count is sceneOffsets[sceneCount]; same layout as SelectNearest.
+        void QueryNearest(Point const* points, uint32_t const* sceneOffsets, uint32_t sceneCount, uint32_t k,
+                          float* nearestDistanceMatrix, uint32_t* nearestIdMatrix);
+
+        // CSR output with one row per point, the point itself included.
+        void QueryRadius(Point const* points, uint32_t const* sceneOffsets, uint32_t sceneCount, float radius, bool sorted);
+
+        uint32_t const* GetNeighborOffsets();
+        float const* GetNeighborDistances();
+        uint32_t const* GetNeighborIds();
+
+    private:
+        struct WorkItem
+        {
+            uint32_t SceneBegin;
+            uint32_t SceneEnd;
+            uint32_t RowBegin;
+            uint32_t RowEnd;
+            uint64_t Cost;
+        };
+
+        std::vector<float> _positionX;
+        std::vector<float> _positionY;
+        std::vector<float> _positionZ;
+        std::vector<uint32_t> _ids;
+
+        std::vector<WorkItem> _workItems;
+        uint32_t _maxSceneSize;
+
+        std::vector<uint32_t> _neighborOffsets;
+        std::vector<float> _neighborDistances;
+        std::vector<uint32_t> _neighborIds;
+
+        void Prepare(Point const* points, uint32_t const* sceneOffsets, uint32_t sceneCount);
+        void CalculateRow(uint32_t row, uint32_t sceneBegin, uint32_t sceneEnd, float* distances);
+    };
+}
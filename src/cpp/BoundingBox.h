@@ -0,0 +1,57 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "Point.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+
+namespace SignalScatter
+{
+    // Axis-aligned bounding box of a cluster of points.
+    struct BoundingBox
+    {
+        float MinimumX;
+        float MinimumY;
+        float MinimumZ;
+        float MaximumX;
+        float MaximumY;
+        float MaximumZ;
+
+        BoundingBox()
+        {
+            MinimumX = MinimumY = MinimumZ = FLT_MAX;
+            MaximumX = MaximumY = MaximumZ = -FLT_MAX;
+        }
+
+        void Add(float x, float y, float z)
+        {
+            MinimumX = std::min(MinimumX, x);
+            MinimumY = std::min(MinimumY, y);
+            MinimumZ = std::min(MinimumZ, z);
+            MaximumX = std::max(MaximumX, x);
+            MaximumY = std::max(MaximumY, y);
+            MaximumZ = std::max(MaximumZ, z);
+        }
+    };
+
+    // Lower bound of the squared distance between any point of a and any point of b.
+    inline float GetMinimumSquaredDistance(BoundingBox const& a, BoundingBox const& b)
+    {
+        float dx = std::max(0.0f, std::max(a.MinimumX - b.MaximumX, b.MinimumX - a.MaximumX));
+        float dy = std::max(0.0f, std::max(a.MinimumY - b.MaximumY, b.MinimumY - a.MaximumY));
+        float dz = std::max(0.0f, std::max(a.MinimumZ - b.MaximumZ, b.MinimumZ - a.MaximumZ));
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    // Upper bound of the squared distance between any point of a and any point of b.
+    inline float GetMaximumSquaredDistance(BoundingBox const& a, BoundingBox const& b)
+    {
+        float dx = std::max(a.MaximumX - b.MinimumX, b.MaximumX - a.MinimumX);
+        float dy = std::max(a.MaximumY - b.MinimumY, b.MaximumY - a.MinimumY);
+        float dz = std::max(a.MaximumZ - b.MinimumZ, b.MaximumZ - a.MinimumZ);
+        return dx * dx + dy * dy + dz * dz;
+    }
+}
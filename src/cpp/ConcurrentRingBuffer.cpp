@@ -5,13 +5,26 @@
 //   - https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
 //
 #include "ConcurrentRingBuffer.h"
+#include "RingGroup.h"
+#include <algorithm>
 #include <atomic>
+#include <cerrno>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <chrono>
 #include <thread>
 #include <iostream>
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
 SignalScatter::ConcurrentRingBuffer::ConcurrentRingBuffer(int capacity)
 {
     int power = (int)std::ceil(std::log2(capacity));
@@ -29,14 +42,57 @@ SignalScatter::ConcurrentRingBuffer::ConcurrentRingBuffer(int capacity)
 
     _enqueuePosition.store(0, std::memory_order_relaxed);
 	_dequeuePosition.store(0, std::memory_order_relaxed);
+
+    _readableEventFd.store(-1, std::memory_order_relaxed);
+    _writableEventFd.store(-1, std::memory_order_relaxed);
+    _lowWatermark.store(0, std::memory_order_relaxed);
+    _readableArmed.store(false, std::memory_order_relaxed);
+    _writableArmed.store(false, std::memory_order_relaxed);
+
+    _group.store(nullptr, std::memory_order_relaxed);
+    _groupMember.store(-1, std::memory_order_relaxed);
 }
 
 SignalScatter::ConcurrentRingBuffer::~ConcurrentRingBuffer()
 {
+    DetachNotifications();
+
     delete[] _buffer;
     delete[] _sequence;
 }
 
+void SignalScatter::ConcurrentRingBuffer::Reset()
+{
+    DetachNotifications();
+
+    // Positions keep running, so only the unread bytes need their sequences handed back to producers.
+    int position = _dequeuePosition.load(std::memory_order_relaxed);
+    int endPosition = _enqueuePosition.load(std::memory_order_relaxed);
+    for (int i = position; i != endPosition; i++)
+    {
+        _sequence[i & _bufferMask].store(i + _bufferMask + 1, std::memory_order_relaxed);
+    }
+    _dequeuePosition.store(endPosition, std::memory_order_release);
+}
+
+void SignalScatter::ConcurrentRingBuffer::DetachNotifications()
+{
+    RingGroup* group = _group.load(std::memory_order_acquire);
+    if (group != nullptr) { group->Remove(_groupMember.load(std::memory_order_relaxed)); }
+
+    int readableEventFd = _readableEventFd.exchange(-1, std::memory_order_acq_rel);
+    int writableEventFd = _writableEventFd.exchange(-1, std::memory_order_acq_rel);
+
+#if defined(__linux__)
+    if (readableEventFd >= 0) { close(readableEventFd); }
+    if (writableEventFd >= 0) { close(writableEventFd); }
+#endif
+
+    _lowWatermark.store(0, std::memory_order_relaxed);
+    _readableArmed.store(false, std::memory_order_relaxed);
+    _writableArmed.store(false, std::memory_order_relaxed);
+}
+
 int SignalScatter::ConcurrentRingBuffer::GetBufferSize()
 {
     return _bufferSize;
@@ -71,6 +127,10 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkEnqueue(ByteSpan const& span)
         int sequence = _sequence[index].load(std::memory_order_acquire);
         int diff = sequence - position;
 
+        // Every byte of the record must have been released; consumers of differently sized records can
+        // leave holes between its first and last byte.
+        if (diff == 0 && GetReleasedLength(position, length) < length) { return false; }
+
         int count = position - _dequeuePosition.load(std::memory_order_relaxed);
 
         if (diff == 0 && length <= (_bufferSize - count)
@@ -78,10 +138,11 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkEnqueue(ByteSpan const& span)
         {
             for (int i = 0; i < length; i++)
             {
-                // int bufferIndex = (position + i) & _bufferMask;
-                _buffer[index + i] = data[i];
-                _sequence[index + i].store(position + 1 + i, std::memory_order_release);
+                int bufferIndex = (position + i) & _bufferMask;
+                _buffer[bufferIndex] = data[i];
+                _sequence[bufferIndex].store(position + 1 + i, std::memory_order_release);
             }
+            NotifyEnqueued();
             return true;
         }
         else if (diff < 0 || length > (_bufferSize - count))
@@ -107,6 +168,10 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkDequeue(ByteSpan& span)
         int sequence = _sequence[index].load(std::memory_order_acquire);
         int diff = sequence - (position + 1);
 
+        // Every byte of the record must be published; producers of differently sized records can
+        // leave holes between its first and last byte.
+        if (diff == 0 && GetPublishedLength(position, length) < length) { return false; }
+
         int count =  _enqueuePosition.load(std::memory_order_relaxed) - position;
 
         if (diff == 0 && _dequeuePosition.compare_exchange_weak(position, position + length, std::memory_order_relaxed))
@@ -119,11 +184,11 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkDequeue(ByteSpan& span)
                 // dest[i] = _buffer[index + i];
                 // _sequence[index + i].store(position + _bufferMask + 1 + i, std::memory_order_release);
             }
+            NotifyDequeued();
             return true;
         }
         else if (diff < 0)
         {
-            std::cout << "********************* BulkDequeue Overflow **********************" << std::endl;
             return false;
         }
 
@@ -136,9 +201,8 @@ void SignalScatter::ConcurrentRingBuffer::Slice(int start, int length, ByteSpan&
 {
     int headPosition = _dequeuePosition.load(std::memory_order_relaxed);;
     int startIndex = (headPosition + start) & _bufferMask;
-    int endIndex = (headPosition + start + length) & _bufferMask;
 
-    if (startIndex <= endIndex)
+    if (startIndex + length <= _bufferSize)
     {
         firstSegmentSpan.Pointer = _buffer + startIndex;
         firstSegmentSpan.Length = length;
@@ -181,8 +245,9 @@ void SignalScatter::ConcurrentRingBuffer::Clear(int length)
         {
             for (int i = 0; i < length; i++)
             {
-                _sequence[index + i].store(position + _bufferMask + 1 + i, std::memory_order_release);
+                _sequence[(position + i) & _bufferMask].store(position + _bufferMask + 1 + i, std::memory_order_release);
             }
+            NotifyDequeued();
             return;
         }
 
@@ -191,6 +256,387 @@ void SignalScatter::ConcurrentRingBuffer::Clear(int length)
     while (true);
 }
 
+int SignalScatter::ConcurrentRingBuffer::Acquire(int maxLength, int recordSize, ByteSpan& firstSegmentSpan, ByteSpan& secondSegmentSpan, int& token)
+{
+    int position;
+    int length;
+    do
+    {
+        position = _dequeuePosition.load(std::memory_order_relaxed);
+        int count = _enqueuePosition.load(std::memory_order_relaxed) - position;
+
+        length = GetPublishedLength(position, std::min(maxLength, count));
+        length -= length % std::max(1, recordSize);
+
+        if (length <= 0)
+        {
+            length = 0;
+            break;
+        }
+        if (_dequeuePosition.compare_exchange_weak(position, position + length, std::memory_order_relaxed)) { break; }
+
+        SpinOnce();
+    }
+    while (true);
+
+    GetSegments(position, length, firstSegmentSpan, secondSegmentSpan);
+    token = position;
+    return length;
+}
+
+void SignalScatter::ConcurrentRingBuffer::Release(int token, int length)
+{
+    for (int i = 0; i < length; i++)
+    {
+        _sequence[(token + i) & _bufferMask].store(token + _bufferMask + 1 + i, std::memory_order_release);
+    }
+    NotifyDequeued();
+}
+
+bool SignalScatter::ConcurrentRingBuffer::TryReserve(int length, ByteSpan& firstSegmentSpan, ByteSpan& secondSegmentSpan, int& token)
+{
+    if (length < 0 || length > _bufferSize) { return false; }
+
+    int position;
+    do
+    {
+        position = _enqueuePosition.load(std::memory_order_relaxed);
+        int count = position - _dequeuePosition.load(std::memory_order_relaxed);
+
+        if (length > _bufferSize - count || GetReleasedLength(position, length) < length) { return false; }
+        if (_enqueuePosition.compare_exchange_weak(position, position + length, std::memory_order_relaxed)) { break; }
+
+        SpinOnce();
+    }
+    while (true);
+
+    GetSegments(position, length, firstSegmentSpan, secondSegmentSpan);
+    token = position;
+    return true;
+}
+
+void SignalScatter::ConcurrentRingBuffer::Commit(int token, int length)
+{
+    for (int i = 0; i < length; i++)
+    {
+        _sequence[(token + i) & _bufferMask].store(token + 1 + i, std::memory_order_release);
+    }
+    if (length > 0) { NotifyEnqueued(); }
+}
+
+int SignalScatter::ConcurrentRingBuffer::EnqueueFromFd(int fd, int maxBytes)
+{
+#if defined(__linux__)
+    if (maxBytes <= 0) { return 0; }
+
+    // Ring space is claimed before the read, so the claim must not exceed what the fd holds.
+    int available = 0;
+    if (ioctl(fd, FIONREAD, &available) < 0) { return -1; }
+
+    if (available == 0)
+    {
+        // Nothing pending: wait (blocking fd) or look (nonblocking fd) to tell an idle stream from its end.
+        bool nonblocking = (fcntl(fd, F_GETFL) & O_NONBLOCK) != 0;
+
+        pollfd pollFd;
+        pollFd.fd = fd;
+        pollFd.events = POLLIN;
+        pollFd.revents = 0;
+
+        int ready;
+        do
+        {
+            ready = poll(&pollFd, 1, nonblocking ? 0 : -1);
+        }
+        while (ready < 0 && errno == EINTR);
+
+        if (ready < 0) { return -1; }
+        if (ready == 0)
+        {
+            errno = EAGAIN;
+            return -1;
+        }
+        if ((pollFd.revents & (POLLERR | POLLNVAL)) != 0)
+        {
+            errno = ((pollFd.revents & POLLNVAL) != 0) ? EBADF : EIO;
+            return -1;
+        }
+
+        if (ioctl(fd, FIONREAD, &available) < 0) { return -1; }
+        if (available == 0) { return 0; }
+    }
+
+    int position;
+    int length;
+    do
+    {
+        position = _enqueuePosition.load(std::memory_order_relaxed);
+        int count = position - _dequeuePosition.load(std::memory_order_relaxed);
+        int limit = std::min(std::min(available, maxBytes), _bufferSize - count);
+
+        length = GetReleasedLength(position, limit);
+
+        if (length == 0 && limit <= 0)
+        {
+            errno = ENOBUFS;
+            return -1;
+        }
+
+        if (length > 0 && _enqueuePosition.compare_exchange_weak(position, position + length, std::memory_order_relaxed))
+        {
+            break;
+        }
+
+        SpinOnce();
+    }
+    while (true);
+
+    int received = 0;
+    int readError = 0;
+    while (received < length)
+    {
+        int startIndex = (position + received) & _bufferMask;
+        int remaining = length - received;
+        int firstSegmentSize = std::min(remaining, _bufferSize - startIndex);
+
+        iovec vectors[2];
+        vectors[0].iov_base = _buffer + startIndex;
+        vectors[0].iov_len = firstSegmentSize;
+        vectors[1].iov_base = _buffer;
+        vectors[1].iov_len = remaining - firstSegmentSize;
+
+        ssize_t result = readv(fd, vectors, (remaining > firstSegmentSize) ? 2 : 1);
+        if (result > 0)
+        {
+            received += (int)result;
+        }
+        else if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else
+        {
+            readError = (result < 0) ? errno : 0;
+            break;
+        }
+    }
+
+    int result = received;
+    if (received < length)
+    {
+        // The fd delivered less than FIONREAD promised, i.e. someone else read from it.
+        // Hand the rest of the claim back if no producer claimed after it, otherwise it has to be
+        // published as zeros to keep the ring consistent, and the caller learns about it through EIO.
+        int expected = position + length;
+        if (_enqueuePosition.compare_exchange_strong(expected, position + received, std::memory_order_relaxed))
+        {
+            length = received;
+            if (received == 0)
+            {
+                errno = readError;
+                result = (readError != 0) ? -1 : 0;
+            }
+        }
+        else
+        {
+            for (int i = received; i < length; i++)
+            {
+                _buffer[(position + i) & _bufferMask] = 0;
+            }
+            errno = EIO;
+            result = -1;
+        }
+    }
+
+    for (int i = 0; i < length; i++)
+    {
+        _sequence[(position + i) & _bufferMask].store(position + 1 + i, std::memory_order_release);
+    }
+    if (length > 0) { NotifyEnqueued(); }
+
+    return result;
+#else
+    (void)fd;
+    (void)maxBytes;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+int SignalScatter::ConcurrentRingBuffer::DequeueToFd(int fd, int maxBytes)
+{
+#if defined(__linux__)
+    int position = _dequeuePosition.load(std::memory_order_relaxed);
+    int limit = std::min(maxBytes, _enqueuePosition.load(std::memory_order_relaxed) - position);
+
+    int length = GetPublishedLength(position, limit);
+    if (length <= 0) { return 0; }
+
+    int startIndex = position & _bufferMask;
+    int firstSegmentSize = std::min(length, _bufferSize - startIndex);
+
+    iovec vectors[2];
+    vectors[0].iov_base = _buffer + startIndex;
+    vectors[0].iov_len = firstSegmentSize;
+    vectors[1].iov_base = _buffer;
+    vectors[1].iov_len = length - firstSegmentSize;
+
+    ssize_t sent;
+    do
+    {
+        sent = writev(fd, vectors, (length > firstSegmentSize) ? 2 : 1);
+    }
+    while (sent < 0 && errno == EINTR);
+
+    if (sent <= 0) { return (int)sent; }
+
+    // Single consumer: the head cannot have moved since it was read above.
+    _dequeuePosition.store(position + (int)sent, std::memory_order_relaxed);
+    for (int i = 0; i < (int)sent; i++)
+    {
+        _sequence[(position + i) & _bufferMask].store(position + _bufferMask + 1 + i, std::memory_order_release);
+    }
+    NotifyDequeued();
+
+    return (int)sent;
+#else
+    (void)fd;
+    (void)maxBytes;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+int SignalScatter::ConcurrentRingBuffer::EnqueueBatch(ByteSpan const* spans, int spanCount)
+{
+    int position;
+    int length;
+    int enqueuedCount;
+    do
+    {
+        position = _enqueuePosition.load(std::memory_order_relaxed);
+        int count = position - _dequeuePosition.load(std::memory_order_relaxed);
+        int space = _bufferSize - count;
+
+        // Longest prefix of whole records that fits; one claim covers all of them.
+        // A negative length would shrink the claim, so it ends the prefix.
+        length = 0;
+        enqueuedCount = 0;
+        while (enqueuedCount < spanCount && spans[enqueuedCount].Length >= 0 && spans[enqueuedCount].Length <= space - length)
+        {
+            length += spans[enqueuedCount].Length;
+            enqueuedCount++;
+        }
+
+        // Only the bytes of that prefix have to be released; drop the records a lagging consumer still holds.
+        int released = GetReleasedLength(position, length);
+        while (length > released)
+        {
+            enqueuedCount--;
+            length -= spans[enqueuedCount].Length;
+        }
+
+        if (enqueuedCount == 0) { return 0; }
+        if (_enqueuePosition.compare_exchange_weak(position, position + length, std::memory_order_relaxed)) { break; }
+
+        SpinOnce();
+    }
+    while (true);
+
+    int offset = position;
+    for (int i = 0; i < enqueuedCount; i++)
+    {
+        CopyIn(offset, spans[i].Pointer, spans[i].Length);
+        offset += spans[i].Length;
+    }
+
+    for (int i = 0; i < length; i++)
+    {
+        _sequence[(position + i) & _bufferMask].store(position + 1 + i, std::memory_order_release);
+    }
+    if (length > 0) { NotifyEnqueued(); }
+
+    return enqueuedCount;
+}
+
+int SignalScatter::ConcurrentRingBuffer::DequeueBatch(uint8_t* destination, int recordSize, int maxRecordCount)
+{
+    if (recordSize <= 0 || maxRecordCount <= 0) { return 0; }
+
+    int position;
+    int recordCount;
+    do
+    {
+        position = _dequeuePosition.load(std::memory_order_relaxed);
+        int count = _enqueuePosition.load(std::memory_order_relaxed) - position;
+        int limit = (int)std::min((int64_t)count, (int64_t)maxRecordCount * recordSize);
+
+        recordCount = GetPublishedLength(position, limit) / recordSize;
+
+        if (recordCount == 0) { return 0; }
+        if (_dequeuePosition.compare_exchange_weak(position, position + recordCount * recordSize, std::memory_order_relaxed)) { break; }
+
+        SpinOnce();
+    }
+    while (true);
+
+    int length = recordCount * recordSize;
+    int startIndex = position & _bufferMask;
+    int firstSegmentSize = std::min(length, _bufferSize - startIndex);
+    std::memcpy(destination, _buffer + startIndex, firstSegmentSize);
+    if (length > firstSegmentSize) { std::memcpy(destination + firstSegmentSize, _buffer, length - firstSegmentSize); }
+
+    for (int i = 0; i < length; i++)
+    {
+        _sequence[(position + i) & _bufferMask].store(position + _bufferMask + 1 + i, std::memory_order_release);
+    }
+    NotifyDequeued();
+
+    return recordCount;
+}
+
+int SignalScatter::ConcurrentRingBuffer::GetReleasedLength(int position, int limit)
+{
+    // Consumers release bytes one by one, so every byte of a claim has to be checked.
+    int length = 0;
+    while (length < limit && _sequence[(position + length) & _bufferMask].load(std::memory_order_acquire) == position + length)
+    {
+        length++;
+    }
+    return length;
+}
+
+int SignalScatter::ConcurrentRingBuffer::GetPublishedLength(int position, int limit)
+{
+    // Later claims can be published before earlier ones, so only the contiguous published prefix counts.
+    int length = 0;
+    while (length < limit && _sequence[(position + length) & _bufferMask].load(std::memory_order_acquire) == position + length + 1)
+    {
+        length++;
+    }
+    return length;
+}
+
+void SignalScatter::ConcurrentRingBuffer::CopyIn(int position, uint8_t const* data, int length)
+{
+    int startIndex = position & _bufferMask;
+    int firstSegmentSize = std::min(length, _bufferSize - startIndex);
+    if (firstSegmentSize > 0) { std::memcpy(_buffer + startIndex, data, firstSegmentSize); }
+    if (length > firstSegmentSize) { std::memcpy(_buffer, data + firstSegmentSize, length - firstSegmentSize); }
+}
+
+void SignalScatter::ConcurrentRingBuffer::GetSegments(int position, int length, ByteSpan& firstSegmentSpan, ByteSpan& secondSegmentSpan)
+{
+    int startIndex = position & _bufferMask;
+    int firstSegmentSize = std::min(length, _bufferSize - startIndex);
+
+    firstSegmentSpan.Pointer = _buffer + startIndex;
+    firstSegmentSpan.Length = firstSegmentSize;
+
+    secondSegmentSpan.Pointer = _buffer;
+    secondSegmentSpan.Length = length - firstSegmentSize;
+}
+
 void SignalScatter::ConcurrentRingBuffer::SpinOnce()
 {
     // auto start = std::chrono::high_resolution_clock::now();
@@ -230,6 +676,9 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkEnqueueByte4(ByteSpan const& sp
         int sequence = _sequence[index].load(std::memory_order_acquire);
         int diff = sequence - position;
 
+        // Every byte of the record must have been released, not just its first and last.
+        if (diff == 0 && GetReleasedLength(position, length) < length) { return false; }
+
         int count = position - _dequeuePosition.load(std::memory_order_relaxed);
 
         if (diff == 0 && length <= (_bufferSize - count)
@@ -237,18 +686,23 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkEnqueueByte4(ByteSpan const& sp
         {
             // Loop Unrolling
             {
-                _buffer[index + 0] = data[0];
-                _sequence[index + 0].store(position + 1 + 0, std::memory_order_release);
+                int bufferIndex = (position + 0) & _bufferMask;
+                _buffer[bufferIndex] = data[0];
+                _sequence[bufferIndex].store(position + 1 + 0, std::memory_order_release);
 
-                _buffer[index + 1] = data[1];
-                _sequence[index + 1].store(position + 1 + 1, std::memory_order_release);
+                bufferIndex = (position + 1) & _bufferMask;
+                _buffer[bufferIndex] = data[1];
+                _sequence[bufferIndex].store(position + 1 + 1, std::memory_order_release);
 
-                _buffer[index + 2] = data[2];
-                _sequence[index + 2].store(position + 1 + 2, std::memory_order_release);
+                bufferIndex = (position + 2) & _bufferMask;
+                _buffer[bufferIndex] = data[2];
+                _sequence[bufferIndex].store(position + 1 + 2, std::memory_order_release);
 
-                _buffer[index + 3] = data[3];
-                _sequence[index + 3].store(position + 1 + 3, std::memory_order_release);
+                bufferIndex = (position + 3) & _bufferMask;
+                _buffer[bufferIndex] = data[3];
+                _sequence[bufferIndex].store(position + 1 + 3, std::memory_order_release);
             }
+            NotifyEnqueued();
             return true;
         }
         else if (diff < 0 || length > (_bufferSize - count))
@@ -276,6 +730,9 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkEnqueueByte8(ByteSpan const& sp
         int sequence = _sequence[index].load(std::memory_order_acquire);
         int diff = sequence - position;
 
+        // Every byte of the record must have been released, not just its first and last.
+        if (diff == 0 && GetReleasedLength(position, length) < length) { return false; }
+
         int count = position - _dequeuePosition.load(std::memory_order_relaxed);
 
         if (diff == 0 && length <= (_bufferSize - count)
@@ -283,30 +740,39 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkEnqueueByte8(ByteSpan const& sp
         {
             // Loop Unrolling
             {
-                _buffer[index + 0] = data[0];
-                _sequence[index + 0].store(position + 1 + 0, std::memory_order_release);
+                int bufferIndex = (position + 0) & _bufferMask;
+                _buffer[bufferIndex] = data[0];
+                _sequence[bufferIndex].store(position + 1 + 0, std::memory_order_release);
 
-                _buffer[index + 1] = data[1];
-                _sequence[index + 1].store(position + 1 + 1, std::memory_order_release);
+                bufferIndex = (position + 1) & _bufferMask;
+                _buffer[bufferIndex] = data[1];
+                _sequence[bufferIndex].store(position + 1 + 1, std::memory_order_release);
 
-                _buffer[index + 2] = data[2];
-                _sequence[index + 2].store(position + 1 + 2, std::memory_order_release);
+                bufferIndex = (position + 2) & _bufferMask;
+                _buffer[bufferIndex] = data[2];
+                _sequence[bufferIndex].store(position + 1 + 2, std::memory_order_release);
 
-                _buffer[index + 3] = data[3];
-                _sequence[index + 3].store(position + 1 + 3, std::memory_order_release);
+                bufferIndex = (position + 3) & _bufferMask;
+                _buffer[bufferIndex] = data[3];
+                _sequence[bufferIndex].store(position + 1 + 3, std::memory_order_release);
 
-                _buffer[index + 4] = data[4];
-                _sequence[index + 4].store(position + 1 + 4, std::memory_order_release);
+                bufferIndex = (position + 4) & _bufferMask;
+                _buffer[bufferIndex] = data[4];
+                _sequence[bufferIndex].store(position + 1 + 4, std::memory_order_release);
 
-                _buffer[index + 5] = data[5];
-                _sequence[index + 5].store(position + 1 + 5, std::memory_order_release);
+                bufferIndex = (position + 5) & _bufferMask;
+                _buffer[bufferIndex] = data[5];
+                _sequence[bufferIndex].store(position + 1 + 5, std::memory_order_release);
 
-                _buffer[index + 6] = data[6];
-                _sequence[index + 6].store(position + 1 + 6, std::memory_order_release);
+                bufferIndex = (position + 6) & _bufferMask;
+                _buffer[bufferIndex] = data[6];
+                _sequence[bufferIndex].store(position + 1 + 6, std::memory_order_release);
 
-                _buffer[index + 7] = data[7];
-                _sequence[index + 7].store(position + 1 + 7, std::memory_order_release);
+                bufferIndex = (position + 7) & _bufferMask;
+                _buffer[bufferIndex] = data[7];
+                _sequence[bufferIndex].store(position + 1 + 7, std::memory_order_release);
             }
+            NotifyEnqueued();
             return true;
         }
         else if (diff < 0 || length > (_bufferSize - count))
@@ -334,6 +800,9 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkEnqueueByte16(ByteSpan const& s
         int sequence = _sequence[index].load(std::memory_order_acquire);
         int diff = sequence - position;
 
+        // Every byte of the record must have been released, not just its first and last.
+        if (diff == 0 && GetReleasedLength(position, length) < length) { return false; }
+
         int count = position - _dequeuePosition.load(std::memory_order_relaxed);
 
         if (diff == 0 && length <= (_bufferSize - count)
@@ -341,54 +810,71 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkEnqueueByte16(ByteSpan const& s
         {
             // Loop Unrolling
             {
-                _buffer[index + 0] = data[0];
-                _sequence[index + 0].store(position + 1 + 0, std::memory_order_release);
+                int bufferIndex = (position + 0) & _bufferMask;
+                _buffer[bufferIndex] = data[0];
+                _sequence[bufferIndex].store(position + 1 + 0, std::memory_order_release);
 
-                _buffer[index + 1] = data[1];
-                _sequence[index + 1].store(position + 1 + 1, std::memory_order_release);
+                bufferIndex = (position + 1) & _bufferMask;
+                _buffer[bufferIndex] = data[1];
+                _sequence[bufferIndex].store(position + 1 + 1, std::memory_order_release);
 
-                _buffer[index + 2] = data[2];
-                _sequence[index + 2].store(position + 1 + 2, std::memory_order_release);
+                bufferIndex = (position + 2) & _bufferMask;
+                _buffer[bufferIndex] = data[2];
+                _sequence[bufferIndex].store(position + 1 + 2, std::memory_order_release);
 
-                _buffer[index + 3] = data[3];
-                _sequence[index + 3].store(position + 1 + 3, std::memory_order_release);
+                bufferIndex = (position + 3) & _bufferMask;
+                _buffer[bufferIndex] = data[3];
+                _sequence[bufferIndex].store(position + 1 + 3, std::memory_order_release);
 
-                _buffer[index + 4] = data[4];
-                _sequence[index + 4].store(position + 1 + 4, std::memory_order_release);
+                bufferIndex = (position + 4) & _bufferMask;
+                _buffer[bufferIndex] = data[4];
+                _sequence[bufferIndex].store(position + 1 + 4, std::memory_order_release);
 
-                _buffer[index + 5] = data[5];
-                _sequence[index + 5].store(position + 1 + 5, std::memory_order_release);
+                bufferIndex = (position + 5) & _bufferMask;
+                _buffer[bufferIndex] = data[5];
+                _sequence[bufferIndex].store(position + 1 + 5, std::memory_order_release);
 
-                _buffer[index + 6] = data[6];
-                _sequence[index + 6].store(position + 1 + 6, std::memory_order_release);
+                bufferIndex = (position + 6) & _bufferMask;
+                _buffer[bufferIndex] = data[6];
+                _sequence[bufferIndex].store(position + 1 + 6, std::memory_order_release);
 
-                _buffer[index + 7] = data[7];
-                _sequence[index + 7].store(position + 1 + 7, std::memory_order_release);
+                bufferIndex = (position + 7) & _bufferMask;
+                _buffer[bufferIndex] = data[7];
+                _sequence[bufferIndex].store(position + 1 + 7, std::memory_order_release);
 
-                _buffer[index + 8] = data[8];
-                _sequence[index + 8].store(position + 1 + 8, std::memory_order_release);
+                bufferIndex = (position + 8) & _bufferMask;
+                _buffer[bufferIndex] = data[8];
+                _sequence[bufferIndex].store(position + 1 + 8, std::memory_order_release);
 
-                _buffer[index + 9] = data[9];
-                _sequence[index + 9].store(position + 1 + 9, std::memory_order_release);
+                bufferIndex = (position + 9) & _bufferMask;
+                _buffer[bufferIndex] = data[9];
+                _sequence[bufferIndex].store(position + 1 + 9, std::memory_order_release);
 
-                _buffer[index + 10] = data[10];
-                _sequence[index + 10].store(position + 1 + 10, std::memory_order_release);
+                bufferIndex = (position + 10) & _bufferMask;
+                _buffer[bufferIndex] = data[10];
+                _sequence[bufferIndex].store(position + 1 + 10, std::memory_order_release);
 
-                _buffer[index + 11] = data[11];
-                _sequence[index + 11].store(position + 1 + 11, std::memory_order_release);
+                bufferIndex = (position + 11) & _bufferMask;
+                _buffer[bufferIndex] = data[11];
+                _sequence[bufferIndex].store(position + 1 + 11, std::memory_order_release);
 
-                _buffer[index + 12] = data[12];
-                _sequence[index + 12].store(position + 1 + 12, std::memory_order_release);
+                bufferIndex = (position + 12) & _bufferMask;
+                _buffer[bufferIndex] = data[12];
+                _sequence[bufferIndex].store(position + 1 + 12, std::memory_order_release);
 
-                _buffer[index + 13] = data[13];
-                _sequence[index + 13].store(position + 1 + 13, std::memory_order_release);
+                bufferIndex = (position + 13) & _bufferMask;
+                _buffer[bufferIndex] = data[13];
+                _sequence[bufferIndex].store(position + 1 + 13, std::memory_order_release);
 
-                _buffer[index + 14] = data[14];
-                _sequence[index + 14].store(position + 1 + 14, std::memory_order_release);
+                bufferIndex = (position + 14) & _bufferMask;
+                _buffer[bufferIndex] = data[14];
+                _sequence[bufferIndex].store(position + 1 + 14, std::memory_order_release);
 
-                _buffer[index + 15] = data[15];
-                _sequence[index + 15].store(position + 1 + 15, std::memory_order_release);
+                bufferIndex = (position + 15) & _bufferMask;
+                _buffer[bufferIndex] = data[15];
+                _sequence[bufferIndex].store(position + 1 + 15, std::memory_order_release);
             }
+            NotifyEnqueued();
             return true;
         }
         else if (diff < 0 || length > (_bufferSize - count))
@@ -416,6 +902,9 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkEnqueueByte32(ByteSpan const& s
         int sequence = _sequence[index].load(std::memory_order_acquire);
         int diff = sequence - position;
 
+        // Every byte of the record must have been released, not just its first and last.
+        if (diff == 0 && GetReleasedLength(position, length) < length) { return false; }
+
         int count = position - _dequeuePosition.load(std::memory_order_relaxed);
 
         if (diff == 0 && length <= (_bufferSize - count)
@@ -423,102 +912,135 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkEnqueueByte32(ByteSpan const& s
         {
             // Loop Unrolling
             {
-                _buffer[index + 0] = data[0];
-                _sequence[index + 0].store(position + 1 + 0, std::memory_order_release);
+                int bufferIndex = (position + 0) & _bufferMask;
+                _buffer[bufferIndex] = data[0];
+                _sequence[bufferIndex].store(position + 1 + 0, std::memory_order_release);
 
-                _buffer[index + 1] = data[1];
-                _sequence[index + 1].store(position + 1 + 1, std::memory_order_release);
+                bufferIndex = (position + 1) & _bufferMask;
+                _buffer[bufferIndex] = data[1];
+                _sequence[bufferIndex].store(position + 1 + 1, std::memory_order_release);
 
-                _buffer[index + 2] = data[2];
-                _sequence[index + 2].store(position + 1 + 2, std::memory_order_release);
+                bufferIndex = (position + 2) & _bufferMask;
+                _buffer[bufferIndex] = data[2];
+                _sequence[bufferIndex].store(position + 1 + 2, std::memory_order_release);
 
-                _buffer[index + 3] = data[3];
-                _sequence[index + 3].store(position + 1 + 3, std::memory_order_release);
+                bufferIndex = (position + 3) & _bufferMask;
+                _buffer[bufferIndex] = data[3];
+                _sequence[bufferIndex].store(position + 1 + 3, std::memory_order_release);
 
-                _buffer[index + 4] = data[4];
-                _sequence[index + 4].store(position + 1 + 4, std::memory_order_release);
+                bufferIndex = (position + 4) & _bufferMask;
+                _buffer[bufferIndex] = data[4];
+                _sequence[bufferIndex].store(position + 1 + 4, std::memory_order_release);
 
-                _buffer[index + 5] = data[5];
-                _sequence[index + 5].store(position + 1 + 5, std::memory_order_release);
+                bufferIndex = (position + 5) & _bufferMask;
+                _buffer[bufferIndex] = data[5];
+                _sequence[bufferIndex].store(position + 1 + 5, std::memory_order_release);
 
-                _buffer[index + 6] = data[6];
-                _sequence[index + 6].store(position + 1 + 6, std::memory_order_release);
+                bufferIndex = (position + 6) & _bufferMask;
+                _buffer[bufferIndex] = data[6];
+                _sequence[bufferIndex].store(position + 1 + 6, std::memory_order_release);
 
-                _buffer[index + 7] = data[7];
-                _sequence[index + 7].store(position + 1 + 7, std::memory_order_release);
+                bufferIndex = (position + 7) & _bufferMask;
+                _buffer[bufferIndex] = data[7];
+                _sequence[bufferIndex].store(position + 1 + 7, std::memory_order_release);
 
-                _buffer[index + 8] = data[8];
-                _sequence[index + 8].store(position + 1 + 8, std::memory_order_release);
+                bufferIndex = (position + 8) & _bufferMask;
+                _buffer[bufferIndex] = data[8];
+                _sequence[bufferIndex].store(position + 1 + 8, std::memory_order_release);
 
-                _buffer[index + 9] = data[9];
-                _sequence[index + 9].store(position + 1 + 9, std::memory_order_release);
+                bufferIndex = (position + 9) & _bufferMask;
+                _buffer[bufferIndex] = data[9];
+                _sequence[bufferIndex].store(position + 1 + 9, std::memory_order_release);
 
-                _buffer[index + 10] = data[10];
-                _sequence[index + 10].store(position + 1 + 10, std::memory_order_release);
+                bufferIndex = (position + 10) & _bufferMask;
+                _buffer[bufferIndex] = data[10];
+                _sequence[bufferIndex].store(position + 1 + 10, std::memory_order_release);
 
-                _buffer[index + 11] = data[11];
-                _sequence[index + 11].store(position + 1 + 11, std::memory_order_release);
+                bufferIndex = (position + 11) & _bufferMask;
+                _buffer[bufferIndex] = data[11];
+                _sequence[bufferIndex].store(position + 1 + 11, std::memory_order_release);
 
-                _buffer[index + 12] = data[12];
-                _sequence[index + 12].store(position + 1 + 12, std::memory_order_release);
+                bufferIndex = (position + 12) & _bufferMask;
+                _buffer[bufferIndex] = data[12];
+                _sequence[bufferIndex].store(position + 1 + 12, std::memory_order_release);
 
-                _buffer[index + 13] = data[13];
-                _sequence[index + 13].store(position + 1 + 13, std::memory_order_release);
+                bufferIndex = (position + 13) & _bufferMask;
+                _buffer[bufferIndex] = data[13];
+                _sequence[bufferIndex].store(position + 1 + 13, std::memory_order_release);
 
-                _buffer[index + 14] = data[14];
-                _sequence[index + 14].store(position + 1 + 14, std::memory_order_release);
+                bufferIndex = (position + 14) & _bufferMask;
+                _buffer[bufferIndex] = data[14];
+                _sequence[bufferIndex].store(position + 1 + 14, std::memory_order_release);
 
-                _buffer[index + 15] = data[15];
-                _sequence[index + 15].store(position + 1 + 15, std::memory_order_release);
+                bufferIndex = (position + 15) & _bufferMask;
+                _buffer[bufferIndex] = data[15];
+                _sequence[bufferIndex].store(position + 1 + 15, std::memory_order_release);
 
-                _buffer[index + 16] = data[16];
-                _sequence[index + 16].store(position + 1 + 16, std::memory_order_release);
+                bufferIndex = (position + 16) & _bufferMask;
+                _buffer[bufferIndex] = data[16];
+                _sequence[bufferIndex].store(position + 1 + 16, std::memory_order_release);
 
-                _buffer[index + 17] = data[17];
-                _sequence[index + 17].store(position + 1 + 17, std::memory_order_release);
+                bufferIndex = (position + 17) & _bufferMask;
+                _buffer[bufferIndex] = data[17];
+                _sequence[bufferIndex].store(position + 1 + 17, std::memory_order_release);
 
-                _buffer[index + 18] = data[18];
-                _sequence[index + 18].store(position + 1 + 18, std::memory_order_release);
+                bufferIndex = (position + 18) & _bufferMask;
+                _buffer[bufferIndex] = data[18];
+                _sequence[bufferIndex].store(position + 1 + 18, std::memory_order_release);
 
-                _buffer[index + 19] = data[19];
-                _sequence[index + 19].store(position + 1 + 19, std::memory_order_release);
+                bufferIndex = (position + 19) & _bufferMask;
+                _buffer[bufferIndex] = data[19];
+                _sequence[bufferIndex].store(position + 1 + 19, std::memory_order_release);
 
-                _buffer[index + 20] = data[20];
-                _sequence[index + 20].store(position + 1 + 20, std::memory_order_release);
+                bufferIndex = (position + 20) & _bufferMask;
+                _buffer[bufferIndex] = data[20];
+                _sequence[bufferIndex].store(position + 1 + 20, std::memory_order_release);
 
-                _buffer[index + 21] = data[21];
-                _sequence[index + 21].store(position + 1 + 21, std::memory_order_release);
+                bufferIndex = (position + 21) & _bufferMask;
+                _buffer[bufferIndex] = data[21];
+                _sequence[bufferIndex].store(position + 1 + 21, std::memory_order_release);
 
-                _buffer[index + 22] = data[22];
-                _sequence[index + 22].store(position + 1 + 22, std::memory_order_release);
+                bufferIndex = (position + 22) & _bufferMask;
+                _buffer[bufferIndex] = data[22];
+                _sequence[bufferIndex].store(position + 1 + 22, std::memory_order_release);
 
-                _buffer[index + 23] = data[23];
-                _sequence[index + 23].store(position + 1 + 23, std::memory_order_release);
+                bufferIndex = (position + 23) & _bufferMask;
+                _buffer[bufferIndex] = data[23];
+                _sequence[bufferIndex].store(position + 1 + 23, std::memory_order_release);
 
-                _buffer[index + 24] = data[24];
-                _sequence[index + 24].store(position + 1 + 24, std::memory_order_release);
+                bufferIndex = (position + 24) & _bufferMask;
+                _buffer[bufferIndex] = data[24];
+                _sequence[bufferIndex].store(position + 1 + 24, std::memory_order_release);
 
-                _buffer[index + 25] = data[25];
-                _sequence[index + 25].store(position + 1 + 25, std::memory_order_release);
+                bufferIndex = (position + 25) & _bufferMask;
+                _buffer[bufferIndex] = data[25];
+                _sequence[bufferIndex].store(position + 1 + 25, std::memory_order_release);
 
-                _buffer[index + 26] = data[26];
-                _sequence[index + 26].store(position + 1 + 26, std::memory_order_release);
+                bufferIndex = (position + 26) & _bufferMask;
+                _buffer[bufferIndex] = data[26];
+                _sequence[bufferIndex].store(position + 1 + 26, std::memory_order_release);
 
-                _buffer[index + 27] = data[27];
-                _sequence[index + 27].store(position + 1 + 27, std::memory_order_release);
+                bufferIndex = (position + 27) & _bufferMask;
+                _buffer[bufferIndex] = data[27];
+                _sequence[bufferIndex].store(position + 1 + 27, std::memory_order_release);
 
-                _buffer[index + 28] = data[28];
-                _sequence[index + 28].store(position + 1 + 28, std::memory_order_release);
+                bufferIndex = (position + 28) & _bufferMask;
+                _buffer[bufferIndex] = data[28];
+                _sequence[bufferIndex].store(position + 1 + 28, std::memory_order_release);
 
-                _buffer[index + 29] = data[29];
-                _sequence[index + 29].store(position + 1 + 29, std::memory_order_release);
+                bufferIndex = (position + 29) & _bufferMask;
+                _buffer[bufferIndex] = data[29];
+                _sequence[bufferIndex].store(position + 1 + 29, std::memory_order_release);
 
-                _buffer[index + 30] = data[30];
-                _sequence[index + 30].store(position + 1 + 30, std::memory_order_release);
+                bufferIndex = (position + 30) & _bufferMask;
+                _buffer[bufferIndex] = data[30];
+                _sequence[bufferIndex].store(position + 1 + 30, std::memory_order_release);
 
-                _buffer[index + 31] = data[31];
-                _sequence[index + 31].store(position + 1 + 31, std::memory_order_release);
+                bufferIndex = (position + 31) & _bufferMask;
+                _buffer[bufferIndex] = data[31];
+                _sequence[bufferIndex].store(position + 1 + 31, std::memory_order_release);
             }
+            NotifyEnqueued();
             return true;
         }
         else if (diff < 0 || length > (_bufferSize - count))
@@ -546,6 +1068,9 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkDequeueByte4(ByteSpan& span)
         int sequence = _sequence[index].load(std::memory_order_acquire);
         int diff = sequence - (position + 1);
 
+        // Every byte of the record must be published, not just its first and last.
+        if (diff == 0 && GetPublishedLength(position, length) < length) { return false; }
+
         // int count =  _enqueuePosition.load(std::memory_order_relaxed) - position;
 
         if (diff == 0 && _dequeuePosition.compare_exchange_weak(position, position + length, std::memory_order_relaxed))
@@ -570,11 +1095,11 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkDequeueByte4(ByteSpan& span)
                 dest[3] = _buffer[bufferIndex];
                 _sequence[bufferIndex].store(position + _bufferMask + 1 + 3, std::memory_order_release);
             }
+            NotifyDequeued();
             return true;
         }
         else if (diff < 0)
         {
-            std::cout << "********************* BulkDequeue Overflow **********************" << std::endl;
             return false;
         }
 
@@ -597,6 +1122,9 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkDequeueByte8(ByteSpan& span)
         int sequence = _sequence[index].load(std::memory_order_acquire);
         int diff = sequence - (position + 1);
 
+        // Every byte of the record must be published, not just its first and last.
+        if (diff == 0 && GetPublishedLength(position, length) < length) { return false; }
+
         // int count =  _enqueuePosition.load(std::memory_order_relaxed) - position;
 
         if (diff == 0 && _dequeuePosition.compare_exchange_weak(position, position + length, std::memory_order_relaxed))
@@ -637,11 +1165,11 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkDequeueByte8(ByteSpan& span)
                 dest[7] = _buffer[bufferIndex];
                 _sequence[bufferIndex].store(position + _bufferMask + 1 + 7, std::memory_order_release);
             }
+            NotifyDequeued();
             return true;
         }
         else if (diff < 0)
         {
-            std::cout << "********************* BulkDequeue Overflow **********************" << std::endl;
             return false;
         }
 
@@ -664,6 +1192,9 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkDequeueByte16(ByteSpan& span)
         int sequence = _sequence[index].load(std::memory_order_acquire);
         int diff = sequence - (position + 1);
 
+        // Every byte of the record must be published, not just its first and last.
+        if (diff == 0 && GetPublishedLength(position, length) < length) { return false; }
+
         // int count =  _enqueuePosition.load(std::memory_order_relaxed) - position;
 
         if (diff == 0 && _dequeuePosition.compare_exchange_weak(position, position + length, std::memory_order_relaxed))
@@ -736,11 +1267,11 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkDequeueByte16(ByteSpan& span)
                 dest[15] = _buffer[bufferIndex];
                 _sequence[bufferIndex].store(position + _bufferMask + 1 + 15, std::memory_order_release);
             }
+            NotifyDequeued();
             return true;
         }
         else if (diff < 0)
         {
-            std::cout << "********************* BulkDequeue Overflow **********************" << std::endl;
             return false;
         }
 
@@ -763,6 +1294,9 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkDequeueByte32(ByteSpan& span)
         int sequence = _sequence[index].load(std::memory_order_acquire);
         int diff = sequence - (position + 1);
 
+        // Every byte of the record must be published, not just its first and last.
+        if (diff == 0 && GetPublishedLength(position, length) < length) { return false; }
+
         // int count =  _enqueuePosition.load(std::memory_order_relaxed) - position;
 
         if (diff == 0 && _dequeuePosition.compare_exchange_weak(position, position + length, std::memory_order_relaxed))
@@ -899,11 +1433,11 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkDequeueByte32(ByteSpan& span)
                 dest[31] = _buffer[bufferIndex];
                 _sequence[bufferIndex].store(position + _bufferMask + 1 + 31, std::memory_order_release);
             }
+            NotifyDequeued();
             return true;
         }
         else if (diff < 0)
         {
-            std::cout << "********************* BulkDequeue Overflow **********************" << std::endl;
             return false;
         }
 
@@ -911,3 +1445,178 @@ bool SignalScatter::ConcurrentRingBuffer::TryBulkDequeueByte32(ByteSpan& span)
     }
     while (true);
 }
+
+void SignalScatter::ConcurrentRingBuffer::SignalEvent(int fd)
+{
+#if defined(__linux__)
+    eventfd_write(fd, 1);
+#else
+    (void)fd;
+#endif
+}
+
+void SignalScatter::ConcurrentRingBuffer::ResetEvent(int fd)
+{
+#if defined(__linux__)
+    eventfd_t value;
+    eventfd_read(fd, &value); // Nonblocking; fails harmlessly when nothing is pending.
+#else
+    (void)fd;
+#endif
+}
+
+bool SignalScatter::ConcurrentRingBuffer::PollEvent(int fd, int timeoutMilliseconds)
+{
+#if defined(__linux__)
+    pollfd pollFd;
+    pollFd.fd = fd;
+    pollFd.events = POLLIN;
+    pollFd.revents = 0;
+    return poll(&pollFd, 1, timeoutMilliseconds) > 0;
+#else
+    (void)fd;
+    (void)timeoutMilliseconds;
+    return false;
+#endif
+}
+
+int SignalScatter::ConcurrentRingBuffer::EnableReadableEvent()
+{
+#if defined(__linux__)
+    if (_readableEventFd.load(std::memory_order_acquire) < 0)
+    {
+        int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        int expected = -1;
+        if (fd >= 0 && !_readableEventFd.compare_exchange_strong(expected, fd, std::memory_order_acq_rel))
+        {
+            // Another thread enabled it first.
+            close(fd);
+        }
+        else if (fd >= 0)
+        {
+            ArmReadableEvent();
+            if (GetCount() > 0) { SignalEvent(fd); }
+        }
+    }
+#endif
+    return _readableEventFd.load(std::memory_order_acquire);
+}
+
+int SignalScatter::ConcurrentRingBuffer::EnableWritableEvent(int lowWatermark)
+{
+#if defined(__linux__)
+    _lowWatermark.store(lowWatermark, std::memory_order_relaxed);
+    if (_writableEventFd.load(std::memory_order_acquire) < 0)
+    {
+        int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        int expected = -1;
+        if (fd >= 0 && !_writableEventFd.compare_exchange_strong(expected, fd, std::memory_order_acq_rel))
+        {
+            close(fd);
+        }
+    }
+#else
+    (void)lowWatermark;
+#endif
+    return _writableEventFd.load(std::memory_order_acquire);
+}
+
+int SignalScatter::ConcurrentRingBuffer::GetReadableEventFd()
+{
+    return _readableEventFd.load(std::memory_order_acquire);
+}
+
+int SignalScatter::ConcurrentRingBuffer::GetWritableEventFd()
+{
+    return _writableEventFd.load(std::memory_order_acquire);
+}
+
+bool SignalScatter::ConcurrentRingBuffer::ArmReadableEvent()
+{
+    int fd = _readableEventFd.load(std::memory_order_acquire);
+    if (fd < 0) { return false; }
+
+    ResetEvent(fd);
+
+    // Pairs with the fence in NotifyEnqueued: either the producer sees the armed flag,
+    // or this thread sees its data.
+    _readableArmed.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (GetCount() > 0)
+    {
+        _readableArmed.store(false, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool SignalScatter::ConcurrentRingBuffer::ArmWritableEvent()
+{
+    int fd = _writableEventFd.load(std::memory_order_acquire);
+    if (fd < 0) { return false; }
+
+    ResetEvent(fd);
+
+    _writableArmed.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (GetCount() <= _lowWatermark.load(std::memory_order_relaxed))
+    {
+        _writableArmed.store(false, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool SignalScatter::ConcurrentRingBuffer::WaitReadable(int timeoutMilliseconds)
+{
+    if (GetCount() > 0) { return true; }
+    if (!ArmReadableEvent()) { return GetCount() > 0; }
+    return PollEvent(_readableEventFd.load(std::memory_order_acquire), timeoutMilliseconds);
+}
+
+bool SignalScatter::ConcurrentRingBuffer::WaitWritable(int timeoutMilliseconds)
+{
+    int lowWatermark = _lowWatermark.load(std::memory_order_relaxed);
+    if (GetCount() <= lowWatermark) { return true; }
+    if (!ArmWritableEvent()) { return GetCount() <= lowWatermark; }
+    return PollEvent(_writableEventFd.load(std::memory_order_acquire), timeoutMilliseconds);
+}
+
+void SignalScatter::ConcurrentRingBuffer::SetGroup(RingGroup* group, int member)
+{
+    _groupMember.store(member, std::memory_order_relaxed);
+    _group.store(group, std::memory_order_release);
+}
+
+void SignalScatter::ConcurrentRingBuffer::NotifyEnqueued()
+{
+    RingGroup* group = _group.load(std::memory_order_acquire);
+    int fd = _readableEventFd.load(std::memory_order_acquire);
+    if (fd < 0 && group == nullptr) { return; }
+
+    // Pairs with the consumer clearing the armed flag / ready bit before it looks at the ring.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (group != nullptr) { group->MarkReady(_groupMember.load(std::memory_order_relaxed)); }
+
+    // Only the first producer after the consumer armed the event pays for the syscall.
+    if (fd >= 0 && _readableArmed.load(std::memory_order_relaxed) && _readableArmed.exchange(false, std::memory_order_acq_rel))
+    {
+        SignalEvent(fd);
+    }
+}
+
+void SignalScatter::ConcurrentRingBuffer::NotifyDequeued()
+{
+    int fd = _writableEventFd.load(std::memory_order_acquire);
+    if (fd < 0) { return; }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_writableArmed.load(std::memory_order_relaxed) && GetCount() <= _lowWatermark.load(std::memory_order_relaxed)
+        && _writableArmed.exchange(false, std::memory_order_acq_rel))
+    {
+        SignalEvent(fd);
+    }
+}
@@ -9,6 +9,8 @@
 
 namespace SignalScatter
 {
+    class RingGroup;
+
     class ConcurrentRingBuffer
     {
     public:
@@ -22,9 +24,37 @@ namespace SignalScatter
 
         void Clear();
         void Clear(int length);
+        // Discards the content, closes the event fds and leaves its group, so the ring can be recycled.
+        // Only touches the sequences of unread bytes. Must not run concurrently with other operations.
+        void Reset();
 
         void Slice(int start, int length, ByteSpan& firstSegmentSpan, ByteSpan& secondSegmentSpan);
 
+        // Zero-copy access to ring storage. Acquire claims up to maxLength published bytes, rounded down
+        // to whole records of recordSize bytes, for this consumer and exposes them in place (records
+        // still being written end the claim early). TryReserve claims exactly length free bytes for this
+        // producer. The claimed bytes belong to the caller until Release (after reading) or Commit
+        // (after writing) hands back the token with the full claimed length. Safe with any number of
+        // producers and consumers; claims that are held block the ring at that position.
+        int Acquire(int maxLength, int recordSize, ByteSpan& firstSegmentSpan, ByteSpan& secondSegmentSpan, int& token);
+        void Release(int token, int length);
+        bool TryReserve(int length, ByteSpan& firstSegmentSpan, ByteSpan& secondSegmentSpan, int& token);
+        void Commit(int token, int length);
+
+        // Direct readv/writev between an fd and ring storage, with the same return values as
+        // RingBuffer::EnqueueFromFd/DequeueToFd. EnqueueFromFd only claims what FIONREAD reports as
+        // pending, so producers can share the ring as long as each fd is read by one caller only.
+        // DequeueToFd writes out the published prefix and only then consumes what the kernel accepted,
+        // so it requires a single consumer.
+        int EnqueueFromFd(int fd, int maxBytes);
+        int DequeueToFd(int fd, int maxBytes);
+
+        // Batched variants that claim ring space once for many records. EnqueueBatch enqueues the longest
+        // prefix of spans that fits and returns its span count; DequeueBatch dequeues up to maxRecordCount
+        // whole records of recordSize bytes into destination and returns the record count.
+        int EnqueueBatch(ByteSpan const* spans, int spanCount);
+        int DequeueBatch(uint8_t* destination, int recordSize, int maxRecordCount);
+
         bool TryBulkEnqueue(ByteSpan const& span);
         bool TryBulkDequeue(ByteSpan& span);
 
@@ -38,6 +68,30 @@ namespace SignalScatter
         bool TryBulkDequeueByte16(ByteSpan& span);
         bool TryBulkDequeueByte32(ByteSpan& span);
 
+        // Readiness notification through eventfd for epoll loops (Linux only; -1 elsewhere).
+        // The readable fd fires when data arrives after the consumer armed it, the writable fd when the
+        // count drops to lowWatermark or below after a producer armed it. Producers and consumers only
+        // write to the fd on those transitions. Enabling is safe while the ring is in use, but an
+        // enqueue or dequeue that runs concurrently with it may not signal; enable before sharing the
+        // ring to get every transition.
+        int EnableReadableEvent();
+        int EnableWritableEvent(int lowWatermark);
+        int GetReadableEventFd();
+        int GetWritableEventFd();
+
+        // Call once the ring has been drained (or found too full), before waiting on the fd.
+        // Clears the fd and arms the next signal; returns false if the state changed meanwhile,
+        // in which case the caller should drain (or enqueue) again instead of waiting.
+        bool ArmReadableEvent();
+        bool ArmWritableEvent();
+
+        // Arms the event and polls its fd. Returns true when the ring is ready, false on timeout.
+        bool WaitReadable(int timeoutMilliseconds);
+        bool WaitWritable(int timeoutMilliseconds);
+
+        // Enqueues mark the ring ready in the group (see RingGroup, which calls this on Add/Remove).
+        void SetGroup(RingGroup* group, int member);
+
     private:
         std::atomic<int>* _sequence;
         uint8_t* _buffer;
@@ -45,6 +99,26 @@ namespace SignalScatter
         int _bufferSize;
 		std::atomic<int> _enqueuePosition;
 		std::atomic<int> _dequeuePosition;
+
+        std::atomic<int> _readableEventFd;
+        std::atomic<int> _writableEventFd;
+        std::atomic<int> _lowWatermark;
+        std::atomic<bool> _readableArmed;
+        std::atomic<bool> _writableArmed;
+
+        std::atomic<RingGroup*> _group;
+        std::atomic<int> _groupMember;
+
         void SpinOnce();
+        int GetReleasedLength(int position, int limit);
+        int GetPublishedLength(int position, int limit);
+        void CopyIn(int position, uint8_t const* data, int length);
+        void GetSegments(int position, int length, ByteSpan& firstSegmentSpan, ByteSpan& secondSegmentSpan);
+        void DetachNotifications();
+        void NotifyEnqueued();
+        void NotifyDequeued();
+        static void SignalEvent(int fd);
+        static void ResetEvent(int fd);
+        static bool PollEvent(int fd, int timeoutMilliseconds);
     };
 }
\ No newline at end of file
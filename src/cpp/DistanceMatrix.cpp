@@ -0,0 +1,180 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#include "DistanceMatrix.h"
+#include "SortKey.h"
+#include "ThreadPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+SignalScatter::TriangularDistanceMatrix::TriangularDistanceMatrix(uint32_t size)
+{
+    _size = size;
+    _length = (size > 0) ? (size_t)size * (size - 1) / 2 : 0;
+    _distances = new float[_length];
+}
+
+SignalScatter::TriangularDistanceMatrix::~TriangularDistanceMatrix()
+{
+    delete[] _distances;
+}
+
+uint32_t SignalScatter::TriangularDistanceMatrix::GetSize()
+{
+    return _size;
+}
+
+size_t SignalScatter::TriangularDistanceMatrix::GetMemorySize()
+{
+    return _length * sizeof(float);
+}
+
+size_t SignalScatter::TriangularDistanceMatrix::GetRowStart(uint32_t row)
+{
+    return (size_t)row * (2 * (size_t)_size - row - 1) / 2;
+}
+
+float const* SignalScatter::TriangularDistanceMatrix::GetRowSegment(uint32_t row)
+{
+    return _distances + GetRowStart(row);
+}
+
+float SignalScatter::TriangularDistanceMatrix::Get(uint32_t row, uint32_t column)
+{
+    if (row == column) { return 0.0f; }
+    if (row > column)
+    {
+        uint32_t t = row;
+        row = column;
+        column = t;
+    }
+    return _distances[GetRowStart(row) + (column - row - 1)];
+}
+
+void SignalScatter::TriangularDistanceMatrix::Calculate(Point const* points)
+{
+    int size = (int)_size;
+
+    // SoA copy so that the inner loop vectorizes.
+    std::vector<float> positionX(size);
+    std::vector<float> positionY(size);
+    std::vector<float> positionZ(size);
+    for (int i = 0; i < size; i++)
+    {
+        positionX[i] = points[i].PositionX;
+        positionY[i] = points[i].PositionY;
+        positionZ[i] = points[i].PositionZ;
+    }
+
+    float const* x = positionX.data();
+    float const* y = positionY.data();
+    float const* z = positionZ.data();
+
+    // Row lengths shrink linearly, so rows are handed out dynamically.
+    ThreadPool::GetDefault().ParallelFor(0, size, 16, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int row = (int)rangeBegin; row < (int)rangeEnd; row++)
+        {
+            float* distances = _distances + GetRowStart(row);
+            float ax = x[row];
+            float ay = y[row];
+            float az = z[row];
+
+            for (int column = row + 1; column < size; column++)
+            {
+                float dx = ax - x[column];
+                float dy = ay - y[column];
+                float dz = az - z[column];
+                distances[column - row - 1] = dx * dx + dy * dy + dz * dz; // Squared Distance
+            }
+        }
+    });
+}
+
+void SignalScatter::CalculateDistance(uint32_t rowCount, Point const* rowPoints, uint32_t columnCount, Point const* columnPoints,
+                                      float* distanceMatrix, uint32_t* idMatrix)
+{
+    std::vector<float> positionX(columnCount);
+    std::vector<float> positionY(columnCount);
+    std::vector<float> positionZ(columnCount);
+    for (uint32_t i = 0; i < columnCount; i++)
+    {
+        positionX[i] = columnPoints[i].PositionX;
+        positionY[i] = columnPoints[i].PositionY;
+        positionZ[i] = columnPoints[i].PositionZ;
+    }
+
+    float const* x = positionX.data();
+    float const* y = positionY.data();
+    float const* z = positionZ.data();
+
+    ThreadPool::GetDefault().ParallelFor(0, rowCount, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int64_t row = rangeBegin; row < rangeEnd; row++)
+        {
+            float* distances = distanceMatrix + (size_t)row * columnCount;
+            float ax = rowPoints[row].PositionX;
+            float ay = rowPoints[row].PositionY;
+            float az = rowPoints[row].PositionZ;
+
+            for (uint32_t column = 0; column < columnCount; column++)
+            {
+                float dx = ax - x[column];
+                float dy = ay - y[column];
+                float dz = az - z[column];
+                distances[column] = dx * dx + dy * dy + dz * dz; // Squared Distance
+            }
+
+            if (idMatrix != nullptr)
+            {
+                uint32_t* ids = idMatrix + (size_t)row * columnCount;
+                for (uint32_t column = 0; column < columnCount; column++)
+                {
+                    ids[column] = columnPoints[column].Id;
+                }
+            }
+        }
+    });
+}
+
+void SignalScatter::CalculateDistanceKeys(uint32_t size, Point const* points, uint64_t* keyMatrix)
+{
+    ThreadPool::GetDefault().ParallelFor(0, size, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int64_t row = rangeBegin; row < rangeEnd; row++)
+        {
+            Point const& a = points[row];
+            uint64_t* keys = keyMatrix + (size_t)row * size;
+
+            for (uint32_t column = 0; column < size; column++)
+            {
+                float dx = a.PositionX - points[column].PositionX;
+                float dy = a.PositionY - points[column].PositionY;
+                float dz = a.PositionZ - points[column].PositionZ;
+                keys[column] = MakeSortKey(dx * dx + dy * dy + dz * dz, points[column].Id);
+            }
+        }
+    });
+}
+
+void SignalScatter::CalculateQuantizedKeys(uint32_t rowCount, Point const* rowPoints, uint32_t columnCount, Point const* columnPoints,
+                                           float maxDistance, uint32_t* keyMatrix)
+{
+    ThreadPool::GetDefault().ParallelFor(0, rowCount, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int64_t row = rangeBegin; row < rangeEnd; row++)
+        {
+            Point const& a = rowPoints[row];
+            uint32_t* keys = keyMatrix + (size_t)row * columnCount;
+
+            for (uint32_t column = 0; column < columnCount; column++)
+            {
+                float dx = a.PositionX - columnPoints[column].PositionX;
+                float dy = a.PositionY - columnPoints[column].PositionY;
+                float dz = a.PositionZ - columnPoints[column].PositionZ;
+                keys[column] = MakeQuantizedKey(dx * dx + dy * dy + dz * dz, maxDistance, column);
+            }
+        }
+    });
+}
@@ -0,0 +1,53 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "Point.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace SignalScatter
+{
+    // Dense rowCount x columnCount matrix of squared distances between two point sets, e.g. listeners
+    // and emitters. idMatrix, when not null, receives the column points' Point::Id values.
+    void CalculateDistance(uint32_t rowCount, Point const* rowPoints, uint32_t columnCount, Point const* columnPoints,
+                           float* distanceMatrix, uint32_t* idMatrix);
+
+    // Dense size x size matrix of 64-bit sort keys (see SortKey.h); row a holds the keys of d(a, b)
+    // with points[b].Id in the low half, so IDs are not limited to 16 bits.
+    void CalculateDistanceKeys(uint32_t size, Point const* points, uint64_t* keyMatrix);
+
+    // Dense rowCount x columnCount matrix of 32-bit quantized keys (see SortKey.h) with column indices
+    // in the low half. columnCount must not exceed QuantizedMaxColumnCount (65535).
+    void CalculateQuantizedKeys(uint32_t rowCount, Point const* rowPoints, uint32_t columnCount, Point const* columnPoints,
+                                float maxDistance, uint32_t* keyMatrix);
+
+    // Squared distances between all pairs of a point set, stored once per pair.
+    // Only the strictly upper triangle is kept (row-major, size * (size - 1) / 2 floats);
+    // the diagonal is implicitly zero and d(a, b) for a > b is read from d(b, a).
+    // The column index is the ID, so no separate ID matrix is needed.
+    class TriangularDistanceMatrix
+    {
+    public:
+        TriangularDistanceMatrix(uint32_t size);
+        ~TriangularDistanceMatrix();
+
+        uint32_t GetSize();
+        size_t GetMemorySize();
+
+        void Calculate(Point const* points);
+
+        float Get(uint32_t row, uint32_t column);
+
+        // Start of the contiguous entries (row, row + 1) .. (row, size - 1).
+        float const* GetRowSegment(uint32_t row);
+
+    private:
+        float* _distances;
+        uint32_t _size;
+        size_t _length;
+
+        size_t GetRowStart(uint32_t row);
+    };
+}
@@ -0,0 +1,226 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#include "IncrementalNeighborMatrix.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// A moved row whose insertion sort needs more shifts per entry than this is sorted from scratch.
+#define INSERTION_SHIFT_BUDGET_PER_ENTRY 8
+
+SignalScatter::IncrementalNeighborMatrix::IncrementalNeighborMatrix(uint32_t size, float moveThreshold)
+{
+    size_t length = (size_t)size * size;
+
+    _size = size;
+    _squaredMoveThreshold = moveThreshold * moveThreshold;
+    _initialized = false;
+
+    _referenceX = new float[size];
+    _referenceY = new float[size];
+    _referenceZ = new float[size];
+
+    _distances = new float[length];
+    _indices = new uint32_t[length];
+    _ranks = new uint32_t[length];
+
+    _moved = new uint8_t[size];
+    _movedIndices = new uint32_t[size];
+}
+
+SignalScatter::IncrementalNeighborMatrix::~IncrementalNeighborMatrix()
+{
+    delete[] _referenceX;
+    delete[] _referenceY;
+    delete[] _referenceZ;
+    delete[] _distances;
+    delete[] _indices;
+    delete[] _ranks;
+    delete[] _moved;
+    delete[] _movedIndices;
+}
+
+uint32_t SignalScatter::IncrementalNeighborMatrix::GetSize()
+{
+    return _size;
+}
+
+float const* SignalScatter::IncrementalNeighborMatrix::GetSortedDistances(uint32_t row)
+{
+    return _distances + (size_t)row * _size;
+}
+
+uint32_t const* SignalScatter::IncrementalNeighborMatrix::GetSortedIndices(uint32_t row)
+{
+    return _indices + (size_t)row * _size;
+}
+
+float SignalScatter::IncrementalNeighborMatrix::CalculateDistance(uint32_t a, uint32_t b)
+{
+    float dx = _referenceX[a] - _referenceX[b];
+    float dy = _referenceY[a] - _referenceY[b];
+    float dz = _referenceZ[a] - _referenceZ[b];
+    return dx * dx + dy * dy + dz * dz; // Squared Distance
+}
+
+uint32_t SignalScatter::IncrementalNeighborMatrix::Update(Point const* points)
+{
+    int size = (int)_size;
+
+    if (!_initialized)
+    {
+        for (int i = 0; i < size; i++)
+        {
+            _referenceX[i] = points[i].PositionX;
+            _referenceY[i] = points[i].PositionY;
+            _referenceZ[i] = points[i].PositionZ;
+        }
+
+        ThreadPool::GetDefault().ParallelFor(0, size, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+        {
+            for (int row = (int)rangeBegin; row < (int)rangeEnd; row++)
+            {
+                uint32_t* indices = _indices + (size_t)row * size;
+                for (int i = 0; i < size; i++) { indices[i] = i; }
+                ResortRow(row);
+            }
+        });
+
+        _initialized = true;
+        return _size;
+    }
+
+    ThreadPool::GetDefault().ParallelFor(0, size, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int i = (int)rangeBegin; i < (int)rangeEnd; i++)
+        {
+            float dx = points[i].PositionX - _referenceX[i];
+            float dy = points[i].PositionY - _referenceY[i];
+            float dz = points[i].PositionZ - _referenceZ[i];
+            _moved[i] = (dx * dx + dy * dy + dz * dz > _squaredMoveThreshold);
+        }
+    });
+
+    uint32_t movedCount = 0;
+    for (int i = 0; i < size; i++)
+    {
+        if (_moved[i])
+        {
+            _movedIndices[movedCount++] = i;
+            _referenceX[i] = points[i].PositionX;
+            _referenceY[i] = points[i].PositionY;
+            _referenceZ[i] = points[i].PositionZ;
+        }
+    }
+
+    if (movedCount == 0) { return 0; }
+
+    ThreadPool::GetDefault().ParallelFor(0, size, 16, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int row = (int)rangeBegin; row < (int)rangeEnd; row++)
+        {
+            if (_moved[row])
+            {
+                ResortRow(row);
+            }
+            else
+            {
+                for (uint32_t i = 0; i < movedCount; i++)
+                {
+                    RepairEntry(row, _movedIndices[i]);
+                }
+            }
+        }
+    });
+
+    return movedCount;
+}
+
+// Recomputes a whole row and restores its order with an insertion sort seeded by the previous order,
+// which is close to sorted when the point moved only a little.
+void SignalScatter::IncrementalNeighborMatrix::ResortRow(uint32_t row)
+{
+    uint32_t size = _size;
+    float* distances = _distances + (size_t)row * size;
+    uint32_t* indices = _indices + (size_t)row * size;
+    uint32_t* ranks = _ranks + (size_t)row * size;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        distances[i] = CalculateDistance(row, indices[i]);
+    }
+
+    size_t shiftBudget = (size_t)size * INSERTION_SHIFT_BUDGET_PER_ENTRY;
+    size_t shiftCount = 0;
+
+    for (uint32_t i = 1; i < size && shiftCount <= shiftBudget; i++)
+    {
+        float distance = distances[i];
+        uint32_t index = indices[i];
+        uint32_t position = i;
+
+        while (position > 0 && distances[position - 1] > distance)
+        {
+            distances[position] = distances[position - 1];
+            indices[position] = indices[position - 1];
+            position--;
+        }
+
+        distances[position] = distance;
+        indices[position] = index;
+        shiftCount += i - position;
+    }
+
+    if (shiftCount > shiftBudget)
+    {
+        std::vector<std::pair<float, uint32_t>> pairs(size);
+        for (uint32_t i = 0; i < size; i++) { pairs[i] = std::make_pair(distances[i], indices[i]); }
+        std::sort(pairs.begin(), pairs.end());
+        for (uint32_t i = 0; i < size; i++)
+        {
+            distances[i] = pairs[i].first;
+            indices[i] = pairs[i].second;
+        }
+    }
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        ranks[indices[i]] = i;
+    }
+}
+
+// Updates the distance to a single moved point and shifts that entry to its new position.
+void SignalScatter::IncrementalNeighborMatrix::RepairEntry(uint32_t row, uint32_t index)
+{
+    uint32_t size = _size;
+    float* distances = _distances + (size_t)row * size;
+    uint32_t* indices = _indices + (size_t)row * size;
+    uint32_t* ranks = _ranks + (size_t)row * size;
+
+    float distance = CalculateDistance(row, index);
+    uint32_t position = ranks[index];
+
+    while (position > 0 && distances[position - 1] > distance)
+    {
+        distances[position] = distances[position - 1];
+        indices[position] = indices[position - 1];
+        ranks[indices[position]] = position;
+        position--;
+    }
+
+    while (position + 1 < size && distances[position + 1] < distance)
+    {
+        distances[position] = distances[position + 1];
+        indices[position] = indices[position + 1];
+        ranks[indices[position]] = position;
+        position++;
+    }
+
+    distances[position] = distance;
+    indices[position] = index;
+    ranks[index] = position;
+}
@@ -0,0 +1,51 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "Point.h"
+#include <cstdint>
+
+namespace SignalScatter
+{
+    // Keeps every row of the all-pairs distance matrix sorted across frames.
+    // A point is treated as moved once it is more than moveThreshold away from the position its
+    // distances were last computed with; only rows and columns of moved points are recomputed,
+    // and the previous order of each row is repaired instead of being sorted from scratch.
+    // Stored distances are therefore off by at most moveThreshold per endpoint.
+    class IncrementalNeighborMatrix
+    {
+    public:
+        IncrementalNeighborMatrix(uint32_t size, float moveThreshold);
+        ~IncrementalNeighborMatrix();
+
+        uint32_t GetSize();
+
+        // The first call computes and sorts every row. Returns the number of moved points.
+        uint32_t Update(Point const* points);
+
+        // Row entries in ascending order of squared distance; IDs are point indices.
+        float const* GetSortedDistances(uint32_t row);
+        uint32_t const* GetSortedIndices(uint32_t row);
+
+    private:
+        uint32_t _size;
+        float _squaredMoveThreshold;
+        bool _initialized;
+
+        float* _referenceX;
+        float* _referenceY;
+        float* _referenceZ;
+
+        float* _distances;
+        uint32_t* _indices;
+        uint32_t* _ranks; // _ranks[row * size + index] is the position of index in the sorted row.
+
+        uint8_t* _moved;
+        uint32_t* _movedIndices;
+
+        float CalculateDistance(uint32_t a, uint32_t b);
+        void ResortRow(uint32_t row);
+        void RepairEntry(uint32_t row, uint32_t index);
+    };
+}
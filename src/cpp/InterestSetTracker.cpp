@@ -0,0 +1,188 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#include "InterestSetTracker.h"
+#include "NeighborHeap.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+SignalScatter::InterestSetTracker::InterestSetTracker(uint32_t pointCount)
+{
+    _pointCount = pointCount;
+    _enterOffsets.assign(pointCount + 1, 0);
+    _leaveOffsets.assign(pointCount + 1, 0);
+    Reset();
+}
+
+SignalScatter::InterestSetTracker::~InterestSetTracker()
+{
+}
+
+uint32_t SignalScatter::InterestSetTracker::GetPointCount()
+{
+    return _pointCount;
+}
+
+void SignalScatter::InterestSetTracker::Reset()
+{
+    _previousOffsets.assign(_pointCount + 1, 0);
+    _previousIds.clear();
+}
+
+uint32_t const* SignalScatter::InterestSetTracker::GetEnterOffsets()
+{
+    return _enterOffsets.data();
+}
+
+uint32_t const* SignalScatter::InterestSetTracker::GetEnterIds()
+{
+    return _enterIds.data();
+}
+
+uint32_t const* SignalScatter::InterestSetTracker::GetLeaveOffsets()
+{
+    return _leaveOffsets.data();
+}
+
+uint32_t const* SignalScatter::InterestSetTracker::GetLeaveIds()
+{
+    return _leaveIds.data();
+}
+
+void SignalScatter::InterestSetTracker::Update(uint32_t k, uint32_t const* neighborIdMatrix)
+{
+    if (k == 0)
+    {
+        // Stride 0 selects CSR rows in UpdateRows, so pass empty rows explicitly.
+        std::vector<uint32_t> emptyOffsets(_pointCount + 1, 0);
+        UpdateRows(0, emptyOffsets.data(), neighborIdMatrix);
+        return;
+    }
+
+    UpdateRows(k, nullptr, neighborIdMatrix);
+}
+
+void SignalScatter::InterestSetTracker::Update(uint32_t const* neighborOffsets, uint32_t const* neighborIds)
+{
+    UpdateRows(0, neighborOffsets, neighborIds);
+}
+
+// Rows are either fixed-width (stride > 0) or given by offsets.
+void SignalScatter::InterestSetTracker::UpdateRows(uint32_t stride, uint32_t const* neighborOffsets, uint32_t const* neighborIds)
+{
+    int pointCount = (int)_pointCount;
+    size_t length = (stride > 0) ? (size_t)stride * pointCount : neighborOffsets[pointCount];
+
+    _scratchIds.resize(length);
+    _scratchCounts.resize(pointCount);
+
+    // Sort and deduplicate every row in its input slot, then compact into CSR.
+    ThreadPool::GetDefault().ParallelFor(0, pointCount, 64, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int point = (int)rangeBegin; point < (int)rangeEnd; point++)
+        {
+            size_t begin = (stride > 0) ? (size_t)point * stride : neighborOffsets[point];
+            size_t end = (stride > 0) ? begin + stride : neighborOffsets[point + 1];
+
+            uint32_t* ids = _scratchIds.data() + begin;
+            uint32_t* idsEnd = std::copy(neighborIds + begin, neighborIds + end, ids);
+            std::sort(ids, idsEnd);
+            idsEnd = std::unique(ids, idsEnd);
+
+            // InvalidNeighborId sorts last.
+            if (idsEnd != ids && *(idsEnd - 1) == InvalidNeighborId) { idsEnd--; }
+
+            _scratchCounts[point] = (uint32_t)(idsEnd - ids);
+        }
+    });
+
+    _currentOffsets.resize(pointCount + 1);
+    _currentOffsets[0] = 0;
+    for (int point = 0; point < pointCount; point++)
+    {
+        _currentOffsets[point + 1] = _currentOffsets[point] + _scratchCounts[point];
+    }
+    _currentIds.resize(_currentOffsets[pointCount]);
+
+    ThreadPool::GetDefault().ParallelFor(0, pointCount, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int point = (int)rangeBegin; point < (int)rangeEnd; point++)
+        {
+            size_t begin = (stride > 0) ? (size_t)point * stride : neighborOffsets[point];
+            std::copy(_scratchIds.data() + begin, _scratchIds.data() + begin + _scratchCounts[point],
+                      _currentIds.data() + _currentOffsets[point]);
+        }
+    });
+
+    Diff();
+
+    std::swap(_previousOffsets, _currentOffsets);
+    std::swap(_previousIds, _currentIds);
+}
+
+// Merges the sorted previous and current sets of every point, first counting then writing the events.
+void SignalScatter::InterestSetTracker::Diff()
+{
+    int pointCount = (int)_pointCount;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        if (pass == 1)
+        {
+            for (int point = 0; point < pointCount; point++)
+            {
+                _enterOffsets[point + 1] += _enterOffsets[point];
+                _leaveOffsets[point + 1] += _leaveOffsets[point];
+            }
+            _enterIds.resize(_enterOffsets[pointCount]);
+            _leaveIds.resize(_leaveOffsets[pointCount]);
+        }
+
+        ThreadPool::GetDefault().ParallelFor(0, pointCount, 64, [&](int64_t rangeBegin, int64_t rangeEnd)
+        {
+            for (int point = (int)rangeBegin; point < (int)rangeEnd; point++)
+            {
+                uint32_t const* previous = _previousIds.data() + _previousOffsets[point];
+                uint32_t const* previousEnd = _previousIds.data() + _previousOffsets[point + 1];
+                uint32_t const* current = _currentIds.data() + _currentOffsets[point];
+                uint32_t const* currentEnd = _currentIds.data() + _currentOffsets[point + 1];
+
+                uint32_t* enterIds = (pass == 1) ? _enterIds.data() + _enterOffsets[point] : nullptr;
+                uint32_t* leaveIds = (pass == 1) ? _leaveIds.data() + _leaveOffsets[point] : nullptr;
+                uint32_t enterCount = 0;
+                uint32_t leaveCount = 0;
+
+                while (previous != previousEnd || current != currentEnd)
+                {
+                    if (current == currentEnd || (previous != previousEnd && *previous < *current))
+                    {
+                        if (leaveIds != nullptr) { leaveIds[leaveCount] = *previous; }
+                        leaveCount++;
+                        previous++;
+                    }
+                    else if (previous == previousEnd || *current < *previous)
+                    {
+                        if (enterIds != nullptr) { enterIds[enterCount] = *current; }
+                        enterCount++;
+                        current++;
+                    }
+                    else
+                    {
+                        previous++;
+                        current++;
+                    }
+                }
+
+                if (pass == 0)
+                {
+                    _enterOffsets[point + 1] = enterCount;
+                    _leaveOffsets[point + 1] = leaveCount;
+                }
+            }
+        });
+    }
+}
@@ -0,0 +1,55 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace SignalScatter
+{
+    // Keeps the previous frame's neighbor set of every point and reports only the changes:
+    // the IDs that entered and the IDs that left each set, both in CSR layout indexed by point.
+    class InterestSetTracker
+    {
+    public:
+        InterestSetTracker(uint32_t pointCount);
+        ~InterestSetTracker();
+
+        uint32_t GetPointCount();
+
+        // Forgets the previous sets, so the next update reports every neighbor as entered.
+        void Reset();
+
+        // Neighbor sets as a pointCount x k ID matrix (e.g. SelectNearest output).
+        // InvalidNeighborId entries are ignored.
+        void Update(uint32_t k, uint32_t const* neighborIdMatrix);
+
+        // Neighbor sets in CSR layout (e.g. radius query output).
+        void Update(uint32_t const* neighborOffsets, uint32_t const* neighborIds);
+
+        uint32_t const* GetEnterOffsets();
+        uint32_t const* GetEnterIds();
+        uint32_t const* GetLeaveOffsets();
+        uint32_t const* GetLeaveIds();
+
+    private:
+        uint32_t _pointCount;
+
+        // Sets are stored sorted by ID.
+        std::vector<uint32_t> _previousOffsets;
+        std::vector<uint32_t> _previousIds;
+        std::vector<uint32_t> _currentOffsets;
+        std::vector<uint32_t> _currentIds;
+        std::vector<uint32_t> _scratchIds;
+        std::vector<uint32_t> _scratchCounts;
+
+        std::vector<uint32_t> _enterOffsets;
+        std::vector<uint32_t> _enterIds;
+        std::vector<uint32_t> _leaveOffsets;
+        std::vector<uint32_t> _leaveIds;
+
+        void UpdateRows(uint32_t stride, uint32_t const* neighborOffsets, uint32_t const* neighborIds);
+        void Diff();
+    };
+}
@@ -0,0 +1,191 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#include "KdTree.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Subtrees with fewer points than this are built by the spawning thread.
+#define PARALLEL_BUILD_THRESHOLD 4096
+
+SignalScatter::KdTree::KdTree(int leafSize)
+{
+    _leafSize = (leafSize > 0) ? leafSize : 1;
+    _pointCount = 0;
+    _depth = 0;
+}
+
+SignalScatter::KdTree::~KdTree()
+{
+}
+
+int SignalScatter::KdTree::GetPointCount()
+{
+    return _pointCount;
+}
+
+static float GetCoordinate(SignalScatter::Point const& point, int axis)
+{
+    return (axis == 0) ? point.PositionX : (axis == 1) ? point.PositionY : point.PositionZ;
+}
+
+void SignalScatter::KdTree::Build(Point const* points, int count)
+{
+    _pointCount = count;
+
+    // The tree is complete: every leaf sits at _depth and holds at most _leafSize points.
+    int depth = 0;
+    while (((count + (1 << depth) - 1) >> depth) > _leafSize) { depth++; }
+    _depth = depth;
+
+    int internalNodeCount = (1 << depth) - 1;
+    _splitAxis.resize(internalNodeCount);
+    _splitValue.resize(internalNodeCount);
+
+    _indices.resize(count);
+    for (int i = 0; i < count; i++) { _indices[i] = i; }
+
+    BuildNode(points, 0, 0, count, 0);
+
+    _positionX.resize(count);
+    _positionY.resize(count);
+    _positionZ.resize(count);
+    _ids.resize(count);
+
+    ThreadPool::GetDefault().ParallelFor(0, count, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int slot = (int)rangeBegin; slot < (int)rangeEnd; slot++)
+        {
+            Point const& point = points[_indices[slot]];
+            _positionX[slot] = point.PositionX;
+            _positionY[slot] = point.PositionY;
+            _positionZ[slot] = point.PositionZ;
+            _ids[slot] = point.Id;
+        }
+    });
+}
+
+void SignalScatter::KdTree::BuildNode(Point const* points, int node, int begin, int end, int level)
+{
+    if (level == _depth) { return; }
+
+    // Split along the axis with the largest extent.
+    float minimum[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float maximum[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (int i = begin; i < end; i++)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            float value = GetCoordinate(points[_indices[i]], axis);
+            minimum[axis] = std::min(minimum[axis], value);
+            maximum[axis] = std::max(maximum[axis], value);
+        }
+    }
+
+    int splitAxis = 0;
+    for (int axis = 1; axis < 3; axis++)
+    {
+        if (maximum[axis] - minimum[axis] > maximum[splitAxis] - minimum[splitAxis]) { splitAxis = axis; }
+    }
+
+    int middle = begin + (end - begin) / 2;
+    std::nth_element(_indices.begin() + begin, _indices.begin() + middle, _indices.begin() + end,
+        [points, splitAxis](uint32_t a, uint32_t b)
+        {
+            return GetCoordinate(points[a], splitAxis) < GetCoordinate(points[b], splitAxis);
+        });
+
+    _splitAxis[node] = (uint8_t)splitAxis;
+    _splitValue[node] = (middle < end) ? GetCoordinate(points[_indices[middle]], splitAxis) : 0.0f;
+
+    if (end - begin <= PARALLEL_BUILD_THRESHOLD)
+    {
+        BuildNode(points, 2 * node + 1, begin, middle, level + 1);
+        BuildNode(points, 2 * node + 2, middle, end, level + 1);
+        return;
+    }
+
+    ThreadPool& pool = ThreadPool::GetDefault();
+    TaskGroup group;
+    pool.Submit(group, [this, points, node, begin, middle, level]()
+    {
+        BuildNode(points, 2 * node + 1, begin, middle, level + 1);
+    });
+
+    BuildNode(points, 2 * node + 2, middle, end, level + 1);
+
+    pool.Wait(group);
+}
+
+void SignalScatter::KdTree::SearchNode(float x, float y, float z, int node, int begin, int end, int level,
+                                       NeighborHeap& heap, float* leafDistances)
+{
+    if (level == _depth)
+    {
+        int length = end - begin;
+        float const* positionX = _positionX.data() + begin;
+        float const* positionY = _positionY.data() + begin;
+        float const* positionZ = _positionZ.data() + begin;
+
+        // Distances of the whole leaf are computed first so the loop vectorizes.
+        for (int i = 0; i < length; i++)
+        {
+            float dx = positionX[i] - x;
+            float dy = positionY[i] - y;
+            float dz = positionZ[i] - z;
+            leafDistances[i] = dx * dx + dy * dy + dz * dz;
+        }
+
+        heap.PushRange(leafDistances, _ids.data() + begin, (uint32_t)length);
+        return;
+    }
+
+    int middle = begin + (end - begin) / 2;
+    int axis = _splitAxis[node];
+    float difference = ((axis == 0) ? x : (axis == 1) ? y : z) - _splitValue[node];
+
+    if (difference < 0)
+    {
+        SearchNode(x, y, z, 2 * node + 1, begin, middle, level + 1, heap, leafDistances);
+        if (difference * difference < heap.GetThreshold())
+        {
+            SearchNode(x, y, z, 2 * node + 2, middle, end, level + 1, heap, leafDistances);
+        }
+    }
+    else
+    {
+        SearchNode(x, y, z, 2 * node + 2, middle, end, level + 1, heap, leafDistances);
+        if (difference * difference < heap.GetThreshold())
+        {
+            SearchNode(x, y, z, 2 * node + 1, begin, middle, level + 1, heap, leafDistances);
+        }
+    }
+}
+
+void SignalScatter::KdTree::QueryNearest(uint32_t k, float* nearestDistanceMatrix, uint32_t* nearestIdMatrix)
+{
+    if (k == 0) { return; }
+
+    int count = _pointCount;
+
+    ThreadPool::GetDefault().ParallelFor(0, count, 64, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        std::vector<float> heapDistances(k);
+        std::vector<uint32_t> heapIds(k);
+        std::vector<float> leafDistances(_leafSize);
+        NeighborHeap heap(heapDistances.data(), heapIds.data(), k);
+
+        // Queries are issued in tree order so that consecutive queries touch the same leaves.
+        for (int slot = (int)rangeBegin; slot < (int)rangeEnd; slot++)
+        {
+            SearchNode(_positionX[slot], _positionY[slot], _positionZ[slot], 0, 0, count, 0, heap, leafDistances.data());
+
+            size_t row = _indices[slot];
+            heap.Sort(nearestDistanceMatrix + row * k, nearestIdMatrix + row * k);
+        }
+    });
+}
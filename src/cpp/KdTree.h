@@ -0,0 +1,49 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "NeighborHeap.h"
+#include "Point.h"
+#include <cstdint>
+#include <vector>
+
+namespace SignalScatter
+{
+    // Balanced k-d tree with an implicit layout: node n has children 2n + 1 and 2n + 2, and the point
+    // range of a node is derived from its position while descending, so only the split axis and
+    // value are stored per node. Points are kept in tree order as SoA arrays for vectorized leaf scans.
+    class KdTree
+    {
+    public:
+        KdTree(int leafSize = 16);
+        ~KdTree();
+
+        int GetPointCount();
+
+        void Build(Point const* points, int count);
+
+        // Finds the k nearest points of each point of the last Build, the point itself included.
+        // Output matrices are count x k in input order, sorted ascending, with Point::Id values as IDs,
+        // matching the layout of SelectNearest.
+        void QueryNearest(uint32_t k, float* nearestDistanceMatrix, uint32_t* nearestIdMatrix);
+
+    private:
+        int _leafSize;
+        int _pointCount;
+        int _depth;
+
+        std::vector<uint8_t> _splitAxis;
+        std::vector<float> _splitValue;
+
+        std::vector<uint32_t> _indices;
+        std::vector<float> _positionX;
+        std::vector<float> _positionY;
+        std::vector<float> _positionZ;
+        std::vector<uint32_t> _ids;
+
+        void BuildNode(Point const* points, int node, int begin, int end, int level);
+        void SearchNode(float x, float y, float z, int node, int begin, int end, int level,
+                        NeighborHeap& heap, float* leafDistances);
+    };
+}
@@ -0,0 +1,195 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#include "MortonOrder.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#define MORTON_BITS_PER_AXIS 10
+#define RADIX_BITS 10
+#define RADIX_PASS_COUNT 3
+#define RADIX_BUCKET_COUNT (1 << RADIX_BITS)
+
+// The input is split into a fixed number of chunks, each with its own histogram,
+// so the sort is deterministic regardless of the thread count.
+#define RADIX_CHUNK_COUNT 64
+
+// Spreads the lower 10 bits of value so that there are two zero bits between each.
+static uint32_t ExpandBits(uint32_t value)
+{
+    value &= 0x000003FF;
+    value = (value | (value << 16)) & 0x030000FF;
+    value = (value | (value << 8)) & 0x0300F00F;
+    value = (value | (value << 4)) & 0x030C30C3;
+    value = (value | (value << 2)) & 0x09249249;
+    return value;
+}
+
+static uint32_t Quantize(float value, float minimum, float scale)
+{
+    float quantized = (value - minimum) * scale;
+    return (uint32_t)std::min(std::max(quantized, 0.0f), (float)((1 << MORTON_BITS_PER_AXIS) - 1));
+}
+
+SignalScatter::MortonOrder::MortonOrder()
+{
+    _pointCount = 0;
+}
+
+SignalScatter::MortonOrder::~MortonOrder()
+{
+}
+
+uint32_t SignalScatter::MortonOrder::GetPointCount()
+{
+    return _pointCount;
+}
+
+uint32_t const* SignalScatter::MortonOrder::GetPermutation()
+{
+    return _permutation.data();
+}
+
+uint32_t const* SignalScatter::MortonOrder::GetCodes()
+{
+    return _codes.data();
+}
+
+void SignalScatter::MortonOrder::Reorder(Point const* points, uint32_t count, Point* reorderedPoints)
+{
+    _pointCount = count;
+    _codes.resize(count);
+    _permutation.resize(count);
+
+    float minimum[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float maximum[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (uint32_t i = 0; i < count; i++)
+    {
+        minimum[0] = std::min(minimum[0], points[i].PositionX);
+        minimum[1] = std::min(minimum[1], points[i].PositionY);
+        minimum[2] = std::min(minimum[2], points[i].PositionZ);
+        maximum[0] = std::max(maximum[0], points[i].PositionX);
+        maximum[1] = std::max(maximum[1], points[i].PositionY);
+        maximum[2] = std::max(maximum[2], points[i].PositionZ);
+    }
+
+    // A cubic cell keeps the curve isotropic.
+    float extent = std::max(maximum[0] - minimum[0], std::max(maximum[1] - minimum[1], maximum[2] - minimum[2]));
+    float scale = (extent > 0.0f) ? ((1 << MORTON_BITS_PER_AXIS) - 1) / extent : 0.0f;
+
+    ThreadPool::GetDefault().ParallelFor(0, count, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int64_t i = rangeBegin; i < rangeEnd; i++)
+        {
+            uint32_t x = Quantize(points[i].PositionX, minimum[0], scale);
+            uint32_t y = Quantize(points[i].PositionY, minimum[1], scale);
+            uint32_t z = Quantize(points[i].PositionZ, minimum[2], scale);
+            _codes[i] = (ExpandBits(x) << 2) | (ExpandBits(y) << 1) | ExpandBits(z);
+            _permutation[i] = (uint32_t)i;
+        }
+    });
+
+    SortByCode();
+
+    ThreadPool::GetDefault().ParallelFor(0, count, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int64_t i = rangeBegin; i < rangeEnd; i++)
+        {
+            reorderedPoints[i] = points[_permutation[i]];
+        }
+    });
+}
+
+// LSD radix sort of (code, index) pairs. Stable, so equal codes keep their input order.
+void SignalScatter::MortonOrder::SortByCode()
+{
+    uint32_t count = _pointCount;
+    uint32_t chunkSize = (count + RADIX_CHUNK_COUNT - 1) / RADIX_CHUNK_COUNT;
+
+    _scratchCodes.resize(count);
+    _scratchPermutation.resize(count);
+    _histograms.resize((size_t)RADIX_CHUNK_COUNT * RADIX_BUCKET_COUNT);
+
+    for (int pass = 0; pass < RADIX_PASS_COUNT; pass++)
+    {
+        int shift = pass * RADIX_BITS;
+        uint32_t* histograms = _histograms.data();
+
+        ThreadPool::GetDefault().ParallelFor(0, RADIX_CHUNK_COUNT, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+        {
+            for (int chunk = (int)rangeBegin; chunk < (int)rangeEnd; chunk++)
+            {
+                uint32_t* histogram = histograms + (size_t)chunk * RADIX_BUCKET_COUNT;
+                std::memset(histogram, 0, RADIX_BUCKET_COUNT * sizeof(uint32_t));
+
+                uint32_t begin = std::min(chunk * chunkSize, count);
+                uint32_t end = std::min(begin + chunkSize, count);
+                for (uint32_t i = begin; i < end; i++)
+                {
+                    histogram[(_codes[i] >> shift) & (RADIX_BUCKET_COUNT - 1)]++;
+                }
+            }
+        });
+
+        // Exclusive prefix sum in (bucket, chunk) order gives every chunk its write cursor per bucket.
+        uint32_t sum = 0;
+        for (int bucket = 0; bucket < RADIX_BUCKET_COUNT; bucket++)
+        {
+            for (int chunk = 0; chunk < RADIX_CHUNK_COUNT; chunk++)
+            {
+                uint32_t& value = histograms[(size_t)chunk * RADIX_BUCKET_COUNT + bucket];
+                uint32_t bucketCount = value;
+                value = sum;
+                sum += bucketCount;
+            }
+        }
+
+        ThreadPool::GetDefault().ParallelFor(0, RADIX_CHUNK_COUNT, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+        {
+            for (int chunk = (int)rangeBegin; chunk < (int)rangeEnd; chunk++)
+            {
+                uint32_t* cursors = histograms + (size_t)chunk * RADIX_BUCKET_COUNT;
+
+                uint32_t begin = std::min(chunk * chunkSize, count);
+                uint32_t end = std::min(begin + chunkSize, count);
+                for (uint32_t i = begin; i < end; i++)
+                {
+                    uint32_t destination = cursors[(_codes[i] >> shift) & (RADIX_BUCKET_COUNT - 1)]++;
+                    _scratchCodes[destination] = _codes[i];
+                    _scratchPermutation[destination] = _permutation[i];
+                }
+            }
+        });
+
+        std::swap(_codes, _scratchCodes);
+        std::swap(_permutation, _scratchPermutation);
+    }
+}
+
+void SignalScatter::MortonOrder::RestoreRows(uint32_t width, float const* source, float* destination)
+{
+    ThreadPool::GetDefault().ParallelFor(0, _pointCount, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int64_t i = rangeBegin; i < rangeEnd; i++)
+        {
+            std::copy(source + (size_t)i * width, source + (size_t)(i + 1) * width, destination + (size_t)_permutation[i] * width);
+        }
+    });
+}
+
+void SignalScatter::MortonOrder::RestoreRows(uint32_t width, uint32_t const* source, uint32_t* destination)
+{
+    ThreadPool::GetDefault().ParallelFor(0, _pointCount, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int64_t i = rangeBegin; i < rangeEnd; i++)
+        {
+            std::copy(source + (size_t)i * width, source + (size_t)(i + 1) * width, destination + (size_t)_permutation[i] * width);
+        }
+    });
+}
@@ -0,0 +1,45 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "Point.h"
+#include <cstdint>
+#include <vector>
+
+namespace SignalScatter
+{
+    // Reorders points along a 3D Morton (Z-order) curve so that points close in space are close in memory.
+    // Intended as an optional stage in front of the distance, grid, k-d tree and tiled stages.
+    // Point::Id values are preserved; the permutation maps results of the reordered set back to input order.
+    class MortonOrder
+    {
+    public:
+        MortonOrder();
+        ~MortonOrder();
+
+        uint32_t GetPointCount();
+
+        // Computes 30-bit codes (10 bits per axis over the bounding box), radix-sorts the points by code
+        // and writes them to reorderedPoints.
+        void Reorder(Point const* points, uint32_t count, Point* reorderedPoints);
+
+        // GetPermutation()[i] is the input index of reorderedPoints[i].
+        uint32_t const* GetPermutation();
+        uint32_t const* GetCodes();
+
+        // Moves the rows of a count x width matrix computed for the reordered points back to input order.
+        void RestoreRows(uint32_t width, float const* source, float* destination);
+        void RestoreRows(uint32_t width, uint32_t const* source, uint32_t* destination);
+
+    private:
+        uint32_t _pointCount;
+        std::vector<uint32_t> _codes;
+        std::vector<uint32_t> _permutation;
+        std::vector<uint32_t> _scratchCodes;
+        std::vector<uint32_t> _scratchPermutation;
+        std::vector<uint32_t> _histograms;
+
+        void SortByCode();
+    };
+}
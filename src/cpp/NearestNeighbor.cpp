@@ -0,0 +1,332 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#include "NearestNeighbor.h"
+#include "DistanceMatrix.h"
+#include "NeighborHeap.h"
+#include "SortKey.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Top-k over single-word keys where the smallest key is the nearest neighbor.
+template <typename TKey>
+static void SelectNearestKeys(uint32_t rowCount, uint32_t rowLength, uint32_t k,
+                              TKey const* keyMatrix, TKey* nearestKeyMatrix, TKey invalidKey, TKey outOfRangeKey)
+{
+    SignalScatter::ThreadPool::GetDefault().ParallelFor(0, rowCount, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        // Max-heap of the k smallest keys seen so far.
+        std::vector<TKey> heap;
+        heap.reserve(k);
+
+        for (int64_t row = rangeBegin; row < rangeEnd; row++)
+        {
+            TKey const* keys = keyMatrix + (size_t)row * rowLength;
+            TKey* nearestKeys = nearestKeyMatrix + (size_t)row * k;
+
+            heap.clear();
+            uint32_t column = 0;
+
+            for (; column < rowLength && heap.size() < k; column++)
+            {
+                heap.push_back(keys[column]);
+                std::push_heap(heap.begin(), heap.end());
+            }
+
+            for (; k > 0 && column < rowLength; column += SignalScatter::NeighborHeap::BlockSize)
+            {
+                uint32_t blockEnd = std::min(column + SignalScatter::NeighborHeap::BlockSize, rowLength);
+                TKey threshold = heap.front();
+
+                int candidateCount = 0;
+                for (uint32_t c = column; c < blockEnd; c++)
+                {
+                    candidateCount += (keys[c] < threshold);
+                }
+
+                if (candidateCount == 0) { continue; }
+
+                for (uint32_t c = column; c < blockEnd; c++)
+                {
+                    if (keys[c] < heap.front())
+                    {
+                        std::pop_heap(heap.begin(), heap.end());
+                        heap.back() = keys[c];
+                        std::push_heap(heap.begin(), heap.end());
+                    }
+                }
+            }
+
+            // Out-of-range keys only order by column, so they are padding rather than neighbors.
+            std::sort_heap(heap.begin(), heap.end());
+            size_t inRangeCount = std::lower_bound(heap.begin(), heap.end(), outOfRangeKey) - heap.begin();
+            std::copy(heap.begin(), heap.begin() + inRangeCount, nearestKeys);
+            std::fill(nearestKeys + inRangeCount, nearestKeys + k, invalidKey);
+        }
+    });
+}
+
+void SignalScatter::SelectNearest(uint32_t rowCount, uint32_t rowLength, uint32_t k,
+                                  float const* distanceMatrix, uint32_t const* idMatrix,
+                                  float* nearestDistanceMatrix, uint32_t* nearestIdMatrix)
+{
+    if (k == 0) { return; }
+
+    ThreadPool::GetDefault().ParallelFor(0, rowCount, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        std::vector<float> heapDistances(k);
+        std::vector<uint32_t> heapIds(k);
+        NeighborHeap heap(heapDistances.data(), heapIds.data(), k);
+
+        for (int64_t row = rangeBegin; row < rangeEnd; row++)
+        {
+            size_t rowOffset = (size_t)row * rowLength;
+            uint32_t const* ids = (idMatrix != nullptr) ? idMatrix + rowOffset : nullptr;
+
+            heap.PushRange(distanceMatrix + rowOffset, ids, rowLength);
+            heap.Sort(nearestDistanceMatrix + (size_t)row * k, nearestIdMatrix + (size_t)row * k);
+        }
+    });
+}
+
+void SignalScatter::SelectNearest(TriangularDistanceMatrix& distanceMatrix, uint32_t k,
+                                  float* nearestDistanceMatrix, uint32_t* nearestIdMatrix)
+{
+    if (k == 0) { return; }
+
+    uint32_t size = distanceMatrix.GetSize();
+
+    ThreadPool::GetDefault().ParallelFor(0, size, 16, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        std::vector<float> heapDistances(k);
+        std::vector<uint32_t> heapIds(k);
+        NeighborHeap heap(heapDistances.data(), heapIds.data(), k);
+
+        for (int64_t row = rangeBegin; row < rangeEnd; row++)
+        {
+            // Columns before the diagonal live in earlier rows of the triangle.
+            for (uint32_t column = 0; column < row; column++)
+            {
+                float distance = distanceMatrix.Get(column, (uint32_t)row);
+                if (distance < heap.GetThreshold())
+                {
+                    heap.Push(distance, column);
+                }
+            }
+
+            if (heap.GetThreshold() > 0.0f)
+            {
+                heap.Push(0.0f, (uint32_t)row);
+            }
+
+            heap.PushRange(distanceMatrix.GetRowSegment((uint32_t)row), nullptr, size - (uint32_t)row - 1, (uint32_t)row + 1);
+            heap.Sort(nearestDistanceMatrix + (size_t)row * k, nearestIdMatrix + (size_t)row * k);
+        }
+    });
+}
+
+void SignalScatter::SelectNearest(uint32_t rowCount, uint32_t rowLength, uint32_t k,
+                                  uint64_t const* keyMatrix, uint64_t* nearestKeyMatrix)
+{
+    SelectNearestKeys(rowCount, rowLength, k, keyMatrix, nearestKeyMatrix, InvalidSortKey, InvalidSortKey);
+}
+
+void SignalScatter::SelectNearest(uint32_t rowCount, uint32_t rowLength, uint32_t k,
+                                  uint32_t const* keyMatrix, uint32_t* nearestKeyMatrix)
+{
+    SelectNearestKeys(rowCount, rowLength, k, keyMatrix, nearestKeyMatrix, InvalidQuantizedKey, QuantizedOutOfRangeKey);
+}
+
+void SignalScatter::SortRows(uint32_t rowCount, uint32_t rowLength, uint64_t* keyMatrix)
+{
+    ThreadPool::GetDefault().ParallelFor(0, rowCount, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int64_t row = rangeBegin; row < rangeEnd; row++)
+        {
+            uint64_t* keys = keyMatrix + (size_t)row * rowLength;
+            std::sort(keys, keys + rowLength);
+        }
+    });
+}
+
+uint32_t SignalScatter::CountWithinDistance(uint32_t rowCount, uint32_t rowLength, float maxDistance,
+                                            float const* distanceMatrix, uint32_t* rowOffsets)
+{
+    float squaredMaxDistance = maxDistance * maxDistance;
+
+    ThreadPool::GetDefault().ParallelFor(0, rowCount, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int64_t row = rangeBegin; row < rangeEnd; row++)
+        {
+            float const* distances = distanceMatrix + (size_t)row * rowLength;
+            uint32_t count = 0;
+            for (uint32_t column = 0; column < rowLength; column++)
+            {
+                count += (distances[column] <= squaredMaxDistance);
+            }
+            rowOffsets[row + 1] = count;
+        }
+    });
+
+    rowOffsets[0] = 0;
+    for (uint32_t row = 0; row < rowCount; row++)
+    {
+        rowOffsets[row + 1] += rowOffsets[row];
+    }
+
+    return rowOffsets[rowCount];
+}
+
+void SignalScatter::CompactWithinDistance(uint32_t rowCount, uint32_t rowLength, float maxDistance,
+                                          float const* distanceMatrix, uint32_t const* idMatrix, uint32_t const* rowOffsets,
+                                          float* compactDistances, uint32_t* compactIds)
+{
+    float squaredMaxDistance = maxDistance * maxDistance;
+
+    ThreadPool::GetDefault().ParallelFor(0, rowCount, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        // Survivors are written unconditionally and the cursor advances by the comparison result,
+        // so the scratch rows need one slot of slack.
+        std::vector<float> scratchDistances(rowLength + 1);
+        std::vector<uint32_t> scratchIds(rowLength + 1);
+
+        for (int64_t row = rangeBegin; row < rangeEnd; row++)
+        {
+            size_t rowOffset = (size_t)row * rowLength;
+            float const* distances = distanceMatrix + rowOffset;
+            uint32_t const* ids = (idMatrix != nullptr) ? idMatrix + rowOffset : nullptr;
+            uint32_t count = 0;
+
+            for (uint32_t column = 0; column < rowLength; column++)
+            {
+                scratchDistances[count] = distances[column];
+                scratchIds[count] = (ids != nullptr) ? ids[column] : column;
+                count += (distances[column] <= squaredMaxDistance);
+            }
+
+            std::copy(scratchDistances.begin(), scratchDistances.begin() + count, compactDistances + rowOffsets[row]);
+            std::copy(scratchIds.begin(), scratchIds.begin() + count, compactIds + rowOffsets[row]);
+        }
+    });
+}
+
+void SignalScatter::SortSegments(uint32_t rowCount, uint32_t const* rowOffsets, float* distances, uint32_t* ids)
+{
+    ThreadPool::GetDefault().ParallelFor(0, rowCount, 64, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        std::vector<std::pair<float, uint32_t>> pairs;
+
+        for (int64_t row = rangeBegin; row < rangeEnd; row++)
+        {
+            uint32_t begin = rowOffsets[row];
+            uint32_t end = rowOffsets[row + 1];
+
+            pairs.resize(end - begin);
+            for (uint32_t i = begin; i < end; i++) { pairs[i - begin] = std::make_pair(distances[i], ids[i]); }
+            std::sort(pairs.begin(), pairs.end());
+            for (uint32_t i = begin; i < end; i++)
+            {
+                distances[i] = pairs[i - begin].first;
+                ids[i] = pairs[i - begin].second;
+            }
+        }
+    });
+}
+
+uint32_t SignalScatter::CountInRangeKeys(uint32_t rowCount, uint32_t rowLength, uint32_t const* keyMatrix, uint32_t* rowOffsets)
+{
+    ThreadPool::GetDefault().ParallelFor(0, rowCount, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int64_t row = rangeBegin; row < rangeEnd; row++)
+        {
+            uint32_t const* keys = keyMatrix + (size_t)row * rowLength;
+            uint32_t count = 0;
+            for (uint32_t column = 0; column < rowLength; column++)
+            {
+                count += (keys[column] < QuantizedOutOfRangeKey);
+            }
+            rowOffsets[row + 1] = count;
+        }
+    });
+
+    rowOffsets[0] = 0;
+    for (uint32_t row = 0; row < rowCount; row++)
+    {
+        rowOffsets[row + 1] += rowOffsets[row];
+    }
+
+    return rowOffsets[rowCount];
+}
+
+void SignalScatter::CompactInRangeKeys(uint32_t rowCount, uint32_t rowLength, uint32_t const* keyMatrix,
+                                       uint32_t const* rowOffsets, uint32_t* compactKeys)
+{
+    ThreadPool::GetDefault().ParallelFor(0, rowCount, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        std::vector<uint32_t> scratchKeys(rowLength + 1);
+
+        for (int64_t row = rangeBegin; row < rangeEnd; row++)
+        {
+            uint32_t const* keys = keyMatrix + (size_t)row * rowLength;
+            uint32_t count = 0;
+
+            for (uint32_t column = 0; column < rowLength; column++)
+            {
+                scratchKeys[count] = keys[column];
+                count += (keys[column] < QuantizedOutOfRangeKey);
+            }
+
+            std::copy(scratchKeys.begin(), scratchKeys.begin() + count, compactKeys + rowOffsets[row]);
+        }
+    });
+}
+
+void SignalScatter::SortSegments(uint32_t rowCount, uint32_t const* rowOffsets, uint32_t* keys)
+{
+    ThreadPool::GetDefault().ParallelFor(0, rowCount, 64, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int64_t row = rangeBegin; row < rangeEnd; row++)
+        {
+            std::sort(keys + rowOffsets[row], keys + rowOffsets[row + 1]);
+        }
+    });
+}
+
+void SignalScatter::RerankNearest(uint32_t rowCount, uint32_t k, Point const* rowPoints, Point const* columnPoints,
+                                  uint32_t const* nearestKeyMatrix, float* nearestDistanceMatrix, uint32_t* nearestIdMatrix)
+{
+    ThreadPool::GetDefault().ParallelFor(0, rowCount, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        std::vector<std::pair<float, uint32_t>> pairs;
+
+        for (int64_t row = rangeBegin; row < rangeEnd; row++)
+        {
+            uint32_t const* keys = nearestKeyMatrix + (size_t)row * k;
+            Point const& a = rowPoints[row];
+
+            pairs.clear();
+            for (uint32_t i = 0; i < k && keys[i] < QuantizedOutOfRangeKey; i++)
+            {
+                Point const& b = columnPoints[GetQuantizedKeyIndex(keys[i])];
+                float dx = a.PositionX - b.PositionX;
+                float dy = a.PositionY - b.PositionY;
+                float dz = a.PositionZ - b.PositionZ;
+                pairs.push_back(std::make_pair(dx * dx + dy * dy + dz * dz, b.Id));
+            }
+            std::sort(pairs.begin(), pairs.end());
+
+            float* distances = nearestDistanceMatrix + (size_t)row * k;
+            uint32_t* ids = nearestIdMatrix + (size_t)row * k;
+            for (uint32_t i = 0; i < k; i++)
+            {
+                distances[i] = (i < pairs.size()) ? pairs[i].first : FLT_MAX;
+                ids[i] = (i < pairs.size()) ? pairs[i].second : InvalidNeighborId;
+            }
+        }
+    });
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "Point.h"
+#include <cstdint>
+
+namespace SignalScatter
+{
+    class TriangularDistanceMatrix;
+
+    // Selects the k smallest squared distances of every row of a rowCount x rowLength matrix.
+    // The output matrices are rowCount x k, sorted in ascending order per row.
+    // When idMatrix is null the column index is used as the ID.
+    // Rows shorter than k are padded with (FLT_MAX, InvalidNeighborId).
+    void SelectNearest(uint32_t rowCount, uint32_t rowLength, uint32_t k,
+                       float const* distanceMatrix, uint32_t const* idMatrix,
+                       float* nearestDistanceMatrix, uint32_t* nearestIdMatrix);
+
+    // Same as above for a symmetric matrix in triangular storage. Mirrored entries are read through
+    // the matrix indexing, so the full square is never materialized. IDs are column indices.
+    // Passing k equal to the matrix size yields fully sorted rows.
+    void SelectNearest(TriangularDistanceMatrix& distanceMatrix, uint32_t k,
+                       float* nearestDistanceMatrix, uint32_t* nearestIdMatrix);
+
+    // Composite 64-bit key mode (see SortKey.h). Rows shorter than k are padded with InvalidSortKey.
+    void SelectNearest(uint32_t rowCount, uint32_t rowLength, uint32_t k,
+                       uint64_t const* keyMatrix, uint64_t* nearestKeyMatrix);
+
+    // Sorts every row of a rowCount x rowLength key matrix in ascending order, in place.
+    void SortRows(uint32_t rowCount, uint32_t rowLength, uint64_t* keyMatrix);
+
+    // Radius cut-off applied before sorting. CountWithinDistance fills the rowCount + 1 CSR offsets of
+    // the entries whose distance is within maxDistance and returns the total, so the caller can size
+    // the output of CompactWithinDistance. SortSegments then sorts only the survivors of each row.
+    uint32_t CountWithinDistance(uint32_t rowCount, uint32_t rowLength, float maxDistance,
+                                 float const* distanceMatrix, uint32_t* rowOffsets);
+
+    void CompactWithinDistance(uint32_t rowCount, uint32_t rowLength, float maxDistance,
+                               float const* distanceMatrix, uint32_t const* idMatrix, uint32_t const* rowOffsets,
+                               float* compactDistances, uint32_t* compactIds);
+
+    void SortSegments(uint32_t rowCount, uint32_t const* rowOffsets, float* distances, uint32_t* ids);
+
+    // Quantized 32-bit key mode (see SortKey.h). Keys beyond the quantization range are dropped by the
+    // compaction, so no distance parameter is needed; rows with fewer than k in-range keys are padded
+    // with InvalidQuantizedKey.
+    void SelectNearest(uint32_t rowCount, uint32_t rowLength, uint32_t k,
+                       uint32_t const* keyMatrix, uint32_t* nearestKeyMatrix);
+
+    uint32_t CountInRangeKeys(uint32_t rowCount, uint32_t rowLength, uint32_t const* keyMatrix, uint32_t* rowOffsets);
+    void CompactInRangeKeys(uint32_t rowCount, uint32_t rowLength, uint32_t const* keyMatrix,
+                            uint32_t const* rowOffsets, uint32_t* compactKeys);
+    void SortSegments(uint32_t rowCount, uint32_t const* rowOffsets, uint32_t* keys);
+
+    // Recomputes exact float distances for the k quantized candidates of every row and orders them exactly.
+    // Candidates tied at the k-th quantization step may be missing; select a few more than needed if the
+    // boundary must be exact. Output IDs are the column points' Point::Id values.
+    void RerankNearest(uint32_t rowCount, uint32_t k, Point const* rowPoints, Point const* columnPoints,
+                       uint32_t const* nearestKeyMatrix, float* nearestDistanceMatrix, uint32_t* nearestIdMatrix);
+}
@@ -0,0 +1,165 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cfloat>
+#include <cstdint>
+
+namespace SignalScatter
+{
+    const uint32_t InvalidNeighborId = 0xFFFFFFFF;
+
+    // Bounded max-heap that keeps the k smallest (squared distance, ID) pairs pushed into it.
+    // The storage is owned by the caller so that per-thread scratch can be reused across rows.
+    class NeighborHeap
+    {
+    public:
+        // Number of candidates tested against the threshold at once by PushRange.
+        static const uint32_t BlockSize = 16;
+
+        NeighborHeap(float* distances, uint32_t* ids, int capacity)
+        {
+            _distances = distances;
+            _ids = ids;
+            _capacity = capacity;
+            _count = 0;
+        }
+
+        int GetCapacity() const { return _capacity; }
+        int GetCount() const { return _count; }
+
+        // Candidates must be strictly below the threshold to enter the heap.
+        // A heap without capacity rejects everything (its storage may be null).
+        float GetThreshold() const
+        {
+            if (_capacity <= 0) { return -FLT_MAX; }
+            return (_count < _capacity) ? FLT_MAX : _distances[0];
+        }
+
+        void Clear()
+        {
+            _count = 0;
+        }
+
+        void Push(float distance, uint32_t id)
+        {
+            if (_count < _capacity)
+            {
+                int index = _count++;
+                while (index > 0)
+                {
+                    int parent = (index - 1) >> 1;
+                    if (_distances[parent] >= distance) { break; }
+                    _distances[index] = _distances[parent];
+                    _ids[index] = _ids[parent];
+                    index = parent;
+                }
+                _distances[index] = distance;
+                _ids[index] = id;
+            }
+            else if (_capacity > 0 && distance < _distances[0])
+            {
+                SiftDown(distance, id, _count);
+            }
+        }
+
+        // Pushes a contiguous run of candidates. When ids is null the IDs are firstId, firstId + 1, ...
+        void PushRange(float const* distances, uint32_t const* ids, uint32_t length, uint32_t firstId = 0)
+        {
+            if (_capacity <= 0) { return; }
+
+            uint32_t column = 0;
+
+            // Every candidate is accepted until the heap is full.
+            for (; column < length && _count < _capacity; column++)
+            {
+                Push(distances[column], (ids != nullptr) ? ids[column] : firstId + column);
+            }
+
+            for (; column + BlockSize <= length; column += BlockSize)
+            {
+                // Branch-free rejection test so that whole blocks beyond the current k-th distance
+                // are skipped with a few vector compares.
+                float threshold = GetThreshold();
+                int candidateCount = 0;
+                for (uint32_t i = 0; i < BlockSize; i++)
+                {
+                    candidateCount += (distances[column + i] < threshold);
+                }
+
+                if (candidateCount == 0) { continue; }
+
+                for (uint32_t i = 0; i < BlockSize; i++)
+                {
+                    uint32_t c = column + i;
+                    if (distances[c] < GetThreshold())
+                    {
+                        Push(distances[c], (ids != nullptr) ? ids[c] : firstId + c);
+                    }
+                }
+            }
+
+            for (; column < length; column++)
+            {
+                if (distances[column] < GetThreshold())
+                {
+                    Push(distances[column], (ids != nullptr) ? ids[column] : firstId + column);
+                }
+            }
+        }
+
+        // Writes the contents in ascending order and pads up to the capacity with
+        // (FLT_MAX, InvalidNeighborId). The heap is empty afterwards.
+        void Sort(float* distances, uint32_t* ids)
+        {
+            int count = _count;
+
+            for (int size = count - 1; size > 0; size--)
+            {
+                float distance = _distances[size];
+                uint32_t id = _ids[size];
+                _distances[size] = _distances[0];
+                _ids[size] = _ids[0];
+                SiftDown(distance, id, size);
+            }
+
+            for (int i = 0; i < count; i++)
+            {
+                distances[i] = _distances[i];
+                ids[i] = _ids[i];
+            }
+            for (int i = count; i < _capacity; i++)
+            {
+                distances[i] = FLT_MAX;
+                ids[i] = InvalidNeighborId;
+            }
+
+            _count = 0;
+        }
+
+    private:
+        float* _distances;
+        uint32_t* _ids;
+        int _capacity;
+        int _count;
+
+        // Places (distance, id) at the root of a heap of the given size and restores the heap order.
+        void SiftDown(float distance, uint32_t id, int size)
+        {
+            int index = 0;
+            while (true)
+            {
+                int child = 2 * index + 1;
+                if (child >= size) { break; }
+                if (child + 1 < size && _distances[child + 1] > _distances[child]) { child++; }
+                if (_distances[child] <= distance) { break; }
+                _distances[index] = _distances[child];
+                _ids[index] = _ids[child];
+                index = child;
+            }
+            _distances[index] = distance;
+            _ids[index] = id;
+        }
+    };
+}
@@ -0,0 +1,352 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#include "PointCodec.h"
+#include "Span.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#define PACKET_HEADER_SIZE 8
+#define FIELD_COUNT 4
+
+static uint32_t EncodeZigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t DecodeZigzag(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static int GetBitWidth(uint32_t const* values, uint32_t count)
+{
+    uint32_t bits = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        bits |= values[i];
+    }
+
+    int width = 0;
+    while (width < 32 && (bits >> width) != 0) { width++; }
+    return width;
+}
+
+// Packs count values of bitWidth bits LSB first into ceil(count * bitWidth / 8) bytes.
+static uint8_t* PackBits(uint32_t const* values, uint32_t count, int bitWidth, uint8_t* output)
+{
+    uint64_t accumulator = 0;
+    int bits = 0;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        accumulator |= (uint64_t)values[i] << bits;
+        bits += bitWidth;
+        if (bits >= 32)
+        {
+            uint32_t word = (uint32_t)accumulator;
+            std::memcpy(output, &word, 4);
+            output += 4;
+            accumulator >>= 32;
+            bits -= 32;
+        }
+    }
+
+    while (bits > 0)
+    {
+        *output++ = (uint8_t)accumulator;
+        accumulator >>= 8;
+        bits -= 8;
+    }
+
+    return output;
+}
+
+static uint8_t const* UnpackBits(uint8_t const* input, uint32_t count, int bitWidth, uint32_t* values)
+{
+    if (bitWidth == 0)
+    {
+        std::fill(values, values + count, 0u);
+        return input;
+    }
+
+    uint64_t mask = ((uint64_t)1 << bitWidth) - 1;
+    uint64_t accumulator = 0;
+    int bits = 0;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        while (bits < bitWidth)
+        {
+            accumulator |= (uint64_t)(*input++) << bits;
+            bits += 8;
+        }
+        values[i] = (uint32_t)(accumulator & mask);
+        accumulator >>= bitWidth;
+        bits -= bitWidth;
+    }
+
+    return input;
+}
+
+SignalScatter::PointEncoder::PointEncoder(uint32_t pointCount, float originX, float originY, float originZ, float step)
+{
+    _pointCount = pointCount;
+    _originX = originX;
+    _originY = originY;
+    _originZ = originZ;
+    _inverseStep = 1.0f / step;
+    _baseline.assign((size_t)pointCount * 3, 0);
+}
+
+SignalScatter::PointEncoder::~PointEncoder()
+{
+}
+
+int SignalScatter::PointEncoder::GetMaxEncodedSize(uint32_t count)
+{
+    uint32_t blockCount = (count + BlockSize - 1) / BlockSize;
+    return PACKET_HEADER_SIZE + (int)(blockCount * FIELD_COUNT + count * FIELD_COUNT * sizeof(uint32_t));
+}
+
+void SignalScatter::PointEncoder::Reset()
+{
+    std::fill(_baseline.begin(), _baseline.end(), 0);
+}
+
+int32_t SignalScatter::PointEncoder::Quantize(float value, float origin)
+{
+    // Clamped so that far-away points saturate instead of overflowing.
+    float scaled = std::nearbyint((value - origin) * _inverseStep);
+    scaled = std::min(std::max(scaled, -2147483520.0f), 2147483520.0f);
+    return (int32_t)scaled;
+}
+
+int SignalScatter::PointEncoder::Encode(Point const* points, uint32_t count, uint8_t* output)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (points[i].Id >= _pointCount) { return 0; }
+    }
+
+    uint8_t* cursor = output + PACKET_HEADER_SIZE;
+    uint32_t fields[FIELD_COUNT][BlockSize];
+    uint32_t previousId = 0;
+
+    for (uint32_t blockBegin = 0; blockBegin < count; blockBegin += BlockSize)
+    {
+        uint32_t blockLength = std::min(BlockSize, count - blockBegin);
+
+        for (uint32_t i = 0; i < blockLength; i++)
+        {
+            Point const& point = points[blockBegin + i];
+            int32_t* baseline = _baseline.data() + (size_t)point.Id * 3;
+
+            int32_t x = Quantize(point.PositionX, _originX);
+            int32_t y = Quantize(point.PositionY, _originY);
+            int32_t z = Quantize(point.PositionZ, _originZ);
+
+            // Differences wrap in 32 bits; the decoder adds them back the same way.
+            fields[0][i] = EncodeZigzag((int32_t)(point.Id - previousId));
+            fields[1][i] = EncodeZigzag((int32_t)((uint32_t)x - (uint32_t)baseline[0]));
+            fields[2][i] = EncodeZigzag((int32_t)((uint32_t)y - (uint32_t)baseline[1]));
+            fields[3][i] = EncodeZigzag((int32_t)((uint32_t)z - (uint32_t)baseline[2]));
+
+            baseline[0] = x;
+            baseline[1] = y;
+            baseline[2] = z;
+            previousId = point.Id;
+        }
+
+        int bitWidths[FIELD_COUNT];
+        for (int field = 0; field < FIELD_COUNT; field++)
+        {
+            bitWidths[field] = GetBitWidth(fields[field], blockLength);
+            *cursor++ = (uint8_t)bitWidths[field];
+        }
+        for (int field = 0; field < FIELD_COUNT; field++)
+        {
+            cursor = PackBits(fields[field], blockLength, bitWidths[field], cursor);
+        }
+    }
+
+    uint32_t header[2] = { (uint32_t)(cursor - output), count };
+    std::memcpy(output, header, PACKET_HEADER_SIZE);
+    return (int)header[0];
+}
+
+bool SignalScatter::PointEncoder::Encode(Point const* points, uint32_t count, RingBuffer& ringBuffer)
+{
+    int maxLength = GetMaxEncodedSize(count);
+
+    ByteSpan firstSegment;
+    ByteSpan secondSegment;
+    if (!ringBuffer.TryReserve(maxLength, firstSegment, secondSegment)) { return false; }
+
+    // Reservations that wrap around are encoded into scratch and copied into the two segments.
+    bool contiguous = (firstSegment.Length >= maxLength);
+    if (!contiguous && (int)_scratch.size() < maxLength) { _scratch.resize(maxLength); }
+
+    uint8_t* output = contiguous ? firstSegment.Pointer : _scratch.data();
+    int length = Encode(points, count, output);
+    if (length == 0) { return false; }
+
+    if (!contiguous)
+    {
+        int firstLength = std::min(length, firstSegment.Length);
+        std::memcpy(firstSegment.Pointer, output, firstLength);
+        std::memcpy(secondSegment.Pointer, output + firstLength, length - firstLength);
+    }
+
+    ringBuffer.Commit(length);
+    return true;
+}
+
+SignalScatter::PointDecoder::PointDecoder(uint32_t pointCount, float originX, float originY, float originZ, float step)
+{
+    _pointCount = pointCount;
+    _originX = originX;
+    _originY = originY;
+    _originZ = originZ;
+    _step = step;
+    _baseline.assign((size_t)pointCount * 3, 0);
+}
+
+SignalScatter::PointDecoder::~PointDecoder()
+{
+}
+
+void SignalScatter::PointDecoder::Reset()
+{
+    std::fill(_baseline.begin(), _baseline.end(), 0);
+}
+
+int SignalScatter::PointDecoder::DecodePacket(uint8_t const* packet, uint32_t packetLength, Point* points, uint32_t pointCount)
+{
+    uint32_t header[2];
+    std::memcpy(header, packet, PACKET_HEADER_SIZE);
+    uint32_t count = header[1];
+
+    // Validate the block layout against the packet length before any state changes.
+    uint8_t const* end = packet + packetLength;
+    uint8_t const* check = packet + PACKET_HEADER_SIZE;
+    for (uint64_t blockBegin = 0; blockBegin < count; blockBegin += PointEncoder::BlockSize)
+    {
+        uint32_t blockLength = (uint32_t)std::min<uint64_t>(PointEncoder::BlockSize, count - blockBegin);
+        if (end - check < FIELD_COUNT) { return -1; }
+
+        size_t blockSize = 0;
+        for (int field = 0; field < FIELD_COUNT; field++)
+        {
+            if (check[field] > 32) { return -1; }
+            blockSize += ((size_t)blockLength * check[field] + 7) / 8;
+        }
+        check += FIELD_COUNT;
+
+        if ((size_t)(end - check) < blockSize) { return -1; }
+        check += blockSize;
+    }
+
+    uint8_t const* cursor = packet + PACKET_HEADER_SIZE;
+    uint32_t fields[FIELD_COUNT][PointEncoder::BlockSize];
+    uint32_t id = 0;
+
+    for (uint64_t blockBegin = 0; blockBegin < count; blockBegin += PointEncoder::BlockSize)
+    {
+        uint32_t blockLength = (uint32_t)std::min<uint64_t>(PointEncoder::BlockSize, count - blockBegin);
+
+        int bitWidths[FIELD_COUNT];
+        for (int field = 0; field < FIELD_COUNT; field++)
+        {
+            bitWidths[field] = (int)*cursor++;
+        }
+        for (int field = 0; field < FIELD_COUNT; field++)
+        {
+            cursor = UnpackBits(cursor, blockLength, bitWidths[field], fields[field]);
+        }
+
+        for (uint32_t i = 0; i < blockLength; i++)
+        {
+            id += (uint32_t)DecodeZigzag(fields[0][i]);
+            if (id >= _pointCount) { continue; }
+
+            int32_t* baseline = _baseline.data() + (size_t)id * 3;
+            baseline[0] = (int32_t)((uint32_t)baseline[0] + (uint32_t)DecodeZigzag(fields[1][i]));
+            baseline[1] = (int32_t)((uint32_t)baseline[1] + (uint32_t)DecodeZigzag(fields[2][i]));
+            baseline[2] = (int32_t)((uint32_t)baseline[2] + (uint32_t)DecodeZigzag(fields[3][i]));
+
+            if (id < pointCount)
+            {
+                Point& point = points[id];
+                point.Id = id;
+                point.PositionX = _originX + (float)baseline[0] * _step;
+                point.PositionY = _originY + (float)baseline[1] * _step;
+                point.PositionZ = _originZ + (float)baseline[2] * _step;
+            }
+        }
+    }
+
+    return (int)count;
+}
+
+int SignalScatter::PointDecoder::Decode(uint8_t const* input, int length, Point* points, uint32_t pointCount)
+{
+    if (length < PACKET_HEADER_SIZE) { return 0; }
+
+    uint32_t packetLength;
+    std::memcpy(&packetLength, input, sizeof(uint32_t));
+    if (packetLength < PACKET_HEADER_SIZE || packetLength > INT_MAX) { return -1; }
+    if ((int)packetLength > length) { return 0; }
+
+    if (DecodePacket(input, packetLength, points, pointCount) < 0) { return -1; }
+    return (int)packetLength;
+}
+
+int SignalScatter::PointDecoder::Decode(RingBuffer& ringBuffer, Point* points, uint32_t pointCount)
+{
+    int decodedCount = 0;
+
+    while (ringBuffer.GetCount() >= PACKET_HEADER_SIZE)
+    {
+        ByteSpan firstSegment;
+        ByteSpan secondSegment;
+
+        uint8_t header[PACKET_HEADER_SIZE];
+        ringBuffer.Slice(0, PACKET_HEADER_SIZE, firstSegment, secondSegment);
+        std::memcpy(header, firstSegment.Pointer, firstSegment.Length);
+        std::memcpy(header + firstSegment.Length, secondSegment.Pointer, secondSegment.Length);
+
+        uint32_t packetLength;
+        std::memcpy(&packetLength, header, sizeof(uint32_t));
+
+        // A length that can never be satisfied means the framing is lost; drop what is buffered.
+        if (packetLength < PACKET_HEADER_SIZE || packetLength > (uint32_t)ringBuffer.GetBufferSize())
+        {
+            ringBuffer.Clear();
+            break;
+        }
+        if ((int)packetLength > ringBuffer.GetCount()) { break; }
+
+        // Packets are decoded in place unless they wrap around the end of the ring.
+        ringBuffer.Slice(0, (int)packetLength, firstSegment, secondSegment);
+        uint8_t const* packet = firstSegment.Pointer;
+        if (secondSegment.Length > 0)
+        {
+            if (_scratch.size() < packetLength) { _scratch.resize(packetLength); }
+            std::memcpy(_scratch.data(), firstSegment.Pointer, firstSegment.Length);
+            std::memcpy(_scratch.data() + firstSegment.Length, secondSegment.Pointer, secondSegment.Length);
+            packet = _scratch.data();
+        }
+
+        // Malformed packets are skipped as a whole.
+        int packetCount = DecodePacket(packet, packetLength, points, pointCount);
+        if (packetCount > 0) { decodedCount += packetCount; }
+        ringBuffer.Clear((int)packetLength);
+    }
+
+    return decodedCount;
+}
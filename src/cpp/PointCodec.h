@@ -0,0 +1,89 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "Point.h"
+#include "RingBuffer.h"
+#include <cstdint>
+#include <vector>
+
+namespace SignalScatter
+{
+    // Compact wire format for Point streams.
+    //
+    // Positions are quantized to step-sized fixed point relative to a scene origin and coded as the
+    // difference to the last state sent for the same ID (zero for IDs never sent, or after Reset).
+    // IDs are coded as the difference to the previous record of the packet, so sorted batches stay small.
+    // All differences are zigzag coded and bit-packed per block of up to BlockSize records, with one
+    // bit width per field and block.
+    //
+    // Packet: uint32 byte length, uint32 record count, then per block 4 bit widths (id, x, y, z)
+    // followed by the packed id, x, y and z fields.
+    //
+    // The ring is a reliable in-process transport, so a packet counts as acknowledged as soon as it is
+    // committed: the encoder advances its per-ID state on commit, the decoder on decode. Reset on both
+    // sides starts over with absolute positions (a keyframe).
+    class PointEncoder
+    {
+    public:
+        static constexpr uint32_t BlockSize = 32;
+
+        // IDs must be below pointCount.
+        PointEncoder(uint32_t pointCount, float originX, float originY, float originZ, float step);
+        ~PointEncoder();
+
+        static int GetMaxEncodedSize(uint32_t count);
+
+        void Reset();
+
+        // Encodes the points as one packet straight into a ring reservation of GetMaxEncodedSize(count)
+        // bytes and commits the bytes actually used. Fails without side effects when the ring has no room
+        // for the reservation or an ID is out of range.
+        bool Encode(Point const* points, uint32_t count, RingBuffer& ringBuffer);
+
+        // Same packet written to a caller buffer of at least GetMaxEncodedSize(count) bytes. Returns the length.
+        int Encode(Point const* points, uint32_t count, uint8_t* output);
+
+    private:
+        uint32_t _pointCount;
+        float _originX;
+        float _originY;
+        float _originZ;
+        float _inverseStep;
+        std::vector<int32_t> _baseline;
+        std::vector<uint8_t> _scratch;
+
+        int32_t Quantize(float value, float origin);
+    };
+
+    class PointDecoder
+    {
+    public:
+        PointDecoder(uint32_t pointCount, float originX, float originY, float originZ, float step);
+        ~PointDecoder();
+
+        void Reset();
+
+        // Decodes every complete packet in the ring into point storage indexed by Id and releases it.
+        // Malformed packets are skipped; an impossible packet length discards the ring content.
+        // Returns the number of records decoded.
+        int Decode(RingBuffer& ringBuffer, Point* points, uint32_t pointCount);
+
+        // Decodes one packet from contiguous memory. Returns the packet length, 0 if it is incomplete,
+        // or -1 if it is malformed (nothing is decoded then).
+        int Decode(uint8_t const* input, int length, Point* points, uint32_t pointCount);
+
+    private:
+        uint32_t _pointCount;
+        float _originX;
+        float _originY;
+        float _originZ;
+        float _step;
+        std::vector<int32_t> _baseline;
+        std::vector<uint8_t> _scratch;
+
+        // Returns the record count, or -1 if the blocks do not fit in packetLength bytes.
+        int DecodePacket(uint8_t const* packet, uint32_t packetLength, Point* points, uint32_t pointCount);
+    };
+}
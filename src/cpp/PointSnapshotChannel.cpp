@@ -0,0 +1,108 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#include "PointSnapshotChannel.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+SignalScatter::PointSnapshotChannel::PointSnapshotChannel(uint32_t capacity, int maxReaderCount)
+{
+    _capacity = capacity;
+    _bufferCount = std::max(maxReaderCount, 1) + 2;
+    _buffers.reset(new Buffer[_bufferCount]);
+
+    for (int i = 0; i < _bufferCount; i++)
+    {
+        _buffers[i].Points.resize(capacity);
+        _buffers[i].Count = 0;
+        _buffers[i].Frame = 0;
+        _buffers[i].ReaderCount.store(0, std::memory_order_relaxed);
+    }
+
+    _latest.store(0, std::memory_order_seq_cst);
+    _writing = -1;
+    _frame = 0;
+}
+
+SignalScatter::PointSnapshotChannel::~PointSnapshotChannel()
+{
+}
+
+uint32_t SignalScatter::PointSnapshotChannel::GetCapacity()
+{
+    return _capacity;
+}
+
+SignalScatter::Point* SignalScatter::PointSnapshotChannel::BeginWrite(bool carryOver)
+{
+    int latest = _latest.load(std::memory_order_seq_cst);
+
+    // A buffer that is neither the latest nor pinned by a reader. Readers pin before they validate
+    // against _latest (see Acquire), so a buffer seen unpinned here cannot be handed out anymore.
+    int slot = -1;
+    for (int i = 0; i < _bufferCount; i++)
+    {
+        if (i != latest && _buffers[i].ReaderCount.load(std::memory_order_seq_cst) == 0)
+        {
+            slot = i;
+            break;
+        }
+    }
+
+    // Only possible when more readers than maxReaderCount hold snapshots.
+    _writing = slot;
+    if (slot < 0) { return nullptr; }
+
+    Buffer& buffer = _buffers[slot];
+    if (carryOver)
+    {
+        Buffer const& source = _buffers[latest];
+        std::copy(source.Points.begin(), source.Points.begin() + source.Count, buffer.Points.begin());
+    }
+
+    return buffer.Points.data();
+}
+
+void SignalScatter::PointSnapshotChannel::EndWrite(uint32_t count)
+{
+    if (_writing < 0) { return; }
+
+    Buffer& buffer = _buffers[_writing];
+    buffer.Count = std::min(count, _capacity);
+    buffer.Frame = ++_frame;
+
+    _latest.store(_writing, std::memory_order_seq_cst);
+    _writing = -1;
+}
+
+SignalScatter::PointSnapshot SignalScatter::PointSnapshotChannel::Acquire()
+{
+    while (true)
+    {
+        int slot = _latest.load(std::memory_order_seq_cst);
+        Buffer& buffer = _buffers[slot];
+
+        // Pin, then check that the buffer is still the latest. If the writer published in between,
+        // it may already be rewriting this buffer, so try again with the new one.
+        buffer.ReaderCount.fetch_add(1, std::memory_order_seq_cst);
+        if (_latest.load(std::memory_order_seq_cst) == slot)
+        {
+            PointSnapshot snapshot;
+            snapshot.Points = buffer.Points.data();
+            snapshot.Count = buffer.Count;
+            snapshot.Frame = buffer.Frame;
+            snapshot.Slot = slot;
+            return snapshot;
+        }
+
+        buffer.ReaderCount.fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
+
+void SignalScatter::PointSnapshotChannel::Release(PointSnapshot const& snapshot)
+{
+    if (snapshot.Slot < 0 || snapshot.Slot >= _bufferCount) { return; }
+
+    _buffers[snapshot.Slot].ReaderCount.fetch_sub(1, std::memory_order_seq_cst);
+}
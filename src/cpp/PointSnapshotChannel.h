@@ -0,0 +1,63 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "Point.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace SignalScatter
+{
+    struct PointSnapshot
+    {
+        Point const* Points;
+        uint32_t Count;
+        // Number of EndWrite calls that produced this snapshot; 0 for the initial empty one.
+        uint64_t Frame;
+        int Slot;
+    };
+
+    // Single-writer, multi-reader "latest value" channel for point clouds.
+    // Holds maxReaderCount + 2 buffers: one being written, the latest published one and one per reader,
+    // so the writer always finds a free buffer and never waits. Readers pin the latest snapshot with a
+    // reference count and read it in place until Release. Each reader holds at most one snapshot at a time.
+    class PointSnapshotChannel
+    {
+    public:
+        PointSnapshotChannel(uint32_t capacity, int maxReaderCount);
+        ~PointSnapshotChannel();
+
+        uint32_t GetCapacity();
+
+        // Writer side. BeginWrite returns a buffer of GetCapacity() points that no reader can see;
+        // with carryOver it starts as a copy of the latest snapshot (for Id-indexed partial updates).
+        // EndWrite publishes its first count points as the latest snapshot. BeginWrite returns nullptr
+        // only if more than maxReaderCount readers hold snapshots.
+        Point* BeginWrite(bool carryOver = false);
+        void EndWrite(uint32_t count);
+
+        // Reader side. The snapshot stays valid and unchanged until it is released.
+        PointSnapshot Acquire();
+        void Release(PointSnapshot const& snapshot);
+
+    private:
+        struct Buffer
+        {
+            std::vector<Point> Points;
+            uint32_t Count;
+            uint64_t Frame;
+            alignas(64) std::atomic<int> ReaderCount;
+        };
+
+        std::unique_ptr<Buffer[]> _buffers;
+        int _bufferCount;
+        uint32_t _capacity;
+
+        alignas(64) std::atomic<int> _latest;
+        int _writing;
+        uint64_t _frame;
+    };
+}
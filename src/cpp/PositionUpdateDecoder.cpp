@@ -0,0 +1,89 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#include "PositionUpdateDecoder.h"
+#include "Span.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+SignalScatter::PositionUpdateDecoder::PositionUpdateDecoder(Point* points, uint32_t pointCount)
+{
+    _points = points;
+    _pointCount = pointCount;
+    _rejectedCount = 0;
+}
+
+SignalScatter::PositionUpdateDecoder::~PositionUpdateDecoder()
+{
+}
+
+void SignalScatter::PositionUpdateDecoder::SetStorage(Point* points, uint32_t pointCount)
+{
+    _points = points;
+    _pointCount = pointCount;
+}
+
+int SignalScatter::PositionUpdateDecoder::GetRejectedCount()
+{
+    return _rejectedCount;
+}
+
+void SignalScatter::PositionUpdateDecoder::DecodeRecords(uint8_t const* data, int recordCount)
+{
+    Point* points = _points;
+    uint32_t pointCount = _pointCount;
+    int rejectedCount = 0;
+
+    // Out-of-range records are written to a scratch slot instead of branching around the store,
+    // which keeps the loop a plain 16-byte load and store per record.
+    Point discarded;
+
+    for (int i = 0; i < recordCount; i++)
+    {
+        Point record;
+        std::memcpy(&record, data + (size_t)i * PositionUpdateRecordSize, PositionUpdateRecordSize);
+
+        bool valid = record.Id < pointCount;
+        Point* target = valid ? points + record.Id : &discarded;
+        *target = record;
+        rejectedCount += !valid;
+    }
+
+    _rejectedCount += rejectedCount;
+}
+
+int SignalScatter::PositionUpdateDecoder::Decode(RingBuffer& ringBuffer, int maxRecordCount)
+{
+    _rejectedCount = 0;
+
+    int recordCount = std::min(ringBuffer.GetCount() / PositionUpdateRecordSize, maxRecordCount);
+    if (recordCount <= 0) { return 0; }
+
+    int length = recordCount * PositionUpdateRecordSize;
+    ByteSpan firstSegment;
+    ByteSpan secondSegment;
+    ringBuffer.Slice(0, length, firstSegment, secondSegment);
+
+    // Whole records of the first segment, the record split across the wrap (if any),
+    // then the rest from the start of the buffer.
+    int firstRecordCount = firstSegment.Length / PositionUpdateRecordSize;
+    DecodeRecords(firstSegment.Pointer, firstRecordCount);
+
+    int headLength = firstSegment.Length - firstRecordCount * PositionUpdateRecordSize;
+    int secondOffset = 0;
+    if (headLength > 0)
+    {
+        uint8_t straddling[PositionUpdateRecordSize];
+        int tailLength = PositionUpdateRecordSize - headLength;
+        std::memcpy(straddling, firstSegment.Pointer + firstSegment.Length - headLength, headLength);
+        std::memcpy(straddling + headLength, secondSegment.Pointer, tailLength);
+        DecodeRecords(straddling, 1);
+        secondOffset = tailLength;
+    }
+
+    DecodeRecords(secondSegment.Pointer + secondOffset, (secondSegment.Length - secondOffset) / PositionUpdateRecordSize);
+
+    ringBuffer.Clear(length);
+    return recordCount;
+}
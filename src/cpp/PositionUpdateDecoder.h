@@ -0,0 +1,42 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "Point.h"
+#include "RingBuffer.h"
+#include <climits>
+#include <cstdint>
+
+namespace SignalScatter
+{
+    // Position update records use the Point layout: Id, PositionX, PositionY, PositionZ (16 bytes).
+    const int PositionUpdateRecordSize = (int)sizeof(Point);
+
+    // Applies position update records straight from a ring to point storage indexed by Id.
+    // Records are read in place through Slice; only a record that straddles the end of the ring
+    // is copied to a temporary. Consumed records are released from the ring afterwards, and a
+    // trailing partial record is left for the next call.
+    class PositionUpdateDecoder
+    {
+    public:
+        PositionUpdateDecoder(Point* points, uint32_t pointCount);
+        ~PositionUpdateDecoder();
+
+        void SetStorage(Point* points, uint32_t pointCount);
+
+        // Records whose Id is out of range in the last Decode call.
+        int GetRejectedCount();
+
+        // Records are applied in ring order, so the last update of an Id wins.
+        // Returns the number of records consumed (applied or rejected).
+        int Decode(RingBuffer& ringBuffer, int maxRecordCount = INT_MAX);
+
+    private:
+        Point* _points;
+        uint32_t _pointCount;
+        int _rejectedCount;
+
+        void DecodeRecords(uint8_t const* data, int recordCount);
+    };
+}
@@ -2,11 +2,18 @@
 // Licensed under the MIT License.
 
 #include "RingBuffer.h"
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 
+#if defined(__linux__)
+#include <sys/uio.h>
+#endif
+
 SignalScatter::RingBuffer::RingBuffer(int capacity)
 {
     int power = (int)std::ceil(std::log2(capacity));
@@ -51,6 +58,12 @@ void SignalScatter::RingBuffer::Clear(int length)
     _dequeuePosition = position + length;
 }
 
+void SignalScatter::RingBuffer::Reset()
+{
+    _enqueuePosition = 0;
+    _dequeuePosition = 0;
+}
+
 void SignalScatter::RingBuffer::Slice(int start, ByteSpan& firstSegmentSpan, ByteSpan& secondSegmentSpan)
 {
     int count = _enqueuePosition - _dequeuePosition;
@@ -61,9 +74,8 @@ void SignalScatter::RingBuffer::Slice(int start, int length, ByteSpan& firstSegm
 {
     int headPosition = _dequeuePosition;
     int startIndex = (headPosition + start) & _bufferMask;
-    int endIndex = (headPosition + start + length) & _bufferMask;
 
-    if (startIndex <= endIndex)
+    if (startIndex + length <= _bufferSize)
     {
         firstSegmentSpan.Pointer = _buffer + startIndex;
         firstSegmentSpan.Length = length;
@@ -84,6 +96,178 @@ void SignalScatter::RingBuffer::Slice(int start, int length, ByteSpan& firstSegm
     }
 }
 
+bool SignalScatter::RingBuffer::TryReserve(int length, ByteSpan& firstSegmentSpan, ByteSpan& secondSegmentSpan)
+{
+    int position = _enqueuePosition;
+    int count = position - _dequeuePosition;
+
+    if (length < 0 || length > (_bufferSize - count)) { return false; }
+
+    int startIndex = position & _bufferMask;
+
+    if (startIndex + length <= _bufferSize)
+    {
+        firstSegmentSpan.Pointer = _buffer + startIndex;
+        firstSegmentSpan.Length = length;
+
+        secondSegmentSpan.Pointer = _buffer;
+        secondSegmentSpan.Length = 0;
+    }
+    else
+    {
+        int firstSegmentSize = _bufferSize - startIndex;
+
+        firstSegmentSpan.Pointer = _buffer + startIndex;
+        firstSegmentSpan.Length = firstSegmentSize;
+
+        secondSegmentSpan.Pointer = _buffer;
+        secondSegmentSpan.Length = length - firstSegmentSize;
+    }
+
+    return true;
+}
+
+void SignalScatter::RingBuffer::Commit(int length)
+{
+    int position = _enqueuePosition;
+
+    int space = _bufferSize - (position - _dequeuePosition);
+    length = (length <= space) ? length : space;
+
+    _enqueuePosition = position + length;
+}
+
+int SignalScatter::RingBuffer::Acquire(int maxLength, ByteSpan& firstSegmentSpan, ByteSpan& secondSegmentSpan, int& token)
+{
+    int length = std::max(0, std::min(maxLength, GetCount()));
+    Slice(0, length, firstSegmentSpan, secondSegmentSpan);
+
+    token = _dequeuePosition;
+    return length;
+}
+
+void SignalScatter::RingBuffer::Release(int token, int length)
+{
+    // A stale token means the bytes were consumed some other way already.
+    if (token != _dequeuePosition) { return; }
+    Clear(length);
+}
+
+int SignalScatter::RingBuffer::EnqueueFromFd(int fd, int maxBytes)
+{
+#if defined(__linux__)
+    if (maxBytes <= 0) { return 0; }
+
+    int length = std::min(maxBytes, _bufferSize - GetCount());
+    if (length <= 0)
+    {
+        errno = ENOBUFS;
+        return -1;
+    }
+
+    ByteSpan firstSegment;
+    ByteSpan secondSegment;
+    TryReserve(length, firstSegment, secondSegment);
+
+    iovec vectors[2];
+    vectors[0].iov_base = firstSegment.Pointer;
+    vectors[0].iov_len = firstSegment.Length;
+    vectors[1].iov_base = secondSegment.Pointer;
+    vectors[1].iov_len = secondSegment.Length;
+
+    ssize_t received;
+    do
+    {
+        received = readv(fd, vectors, (secondSegment.Length > 0) ? 2 : 1);
+    }
+    while (received < 0 && errno == EINTR);
+
+    if (received > 0) { Commit((int)received); }
+    return (int)received;
+#else
+    (void)fd;
+    (void)maxBytes;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+int SignalScatter::RingBuffer::DequeueToFd(int fd, int maxBytes)
+{
+#if defined(__linux__)
+    int length = std::min(maxBytes, GetCount());
+    if (length <= 0) { return 0; }
+
+    ByteSpan firstSegment;
+    ByteSpan secondSegment;
+    Slice(0, length, firstSegment, secondSegment);
+
+    iovec vectors[2];
+    vectors[0].iov_base = firstSegment.Pointer;
+    vectors[0].iov_len = firstSegment.Length;
+    vectors[1].iov_base = secondSegment.Pointer;
+    vectors[1].iov_len = secondSegment.Length;
+
+    ssize_t sent;
+    do
+    {
+        sent = writev(fd, vectors, (secondSegment.Length > 0) ? 2 : 1);
+    }
+    while (sent < 0 && errno == EINTR);
+
+    if (sent > 0) { Clear((int)sent); }
+    return (int)sent;
+#else
+    (void)fd;
+    (void)maxBytes;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+int SignalScatter::RingBuffer::EnqueueBatch(ByteSpan const* spans, int spanCount)
+{
+    int position = _enqueuePosition;
+    int space = _bufferSize - (position - _dequeuePosition);
+
+    // A negative length would move the enqueue position backwards, so it ends the prefix.
+    int enqueuedCount = 0;
+    while (enqueuedCount < spanCount && spans[enqueuedCount].Length >= 0 && spans[enqueuedCount].Length <= space)
+    {
+        ByteSpan const& span = spans[enqueuedCount];
+
+        int startIndex = position & _bufferMask;
+        int firstSegmentSize = std::min(span.Length, _bufferSize - startIndex);
+        if (firstSegmentSize > 0) { std::memcpy(_buffer + startIndex, span.Pointer, firstSegmentSize); }
+        if (span.Length > firstSegmentSize) { std::memcpy(_buffer, span.Pointer + firstSegmentSize, span.Length - firstSegmentSize); }
+
+        position += span.Length;
+        space -= span.Length;
+        enqueuedCount++;
+    }
+
+    _enqueuePosition = position;
+    return enqueuedCount;
+}
+
+int SignalScatter::RingBuffer::DequeueBatch(uint8_t* destination, int recordSize, int maxRecordCount)
+{
+    if (recordSize <= 0 || maxRecordCount <= 0) { return 0; }
+
+    int recordCount = std::min(maxRecordCount, GetCount() / recordSize);
+    if (recordCount == 0) { return 0; }
+
+    ByteSpan firstSegment;
+    ByteSpan secondSegment;
+    Slice(0, recordCount * recordSize, firstSegment, secondSegment);
+
+    std::memcpy(destination, firstSegment.Pointer, firstSegment.Length);
+    if (secondSegment.Length > 0) { std::memcpy(destination + firstSegment.Length, secondSegment.Pointer, secondSegment.Length); }
+
+    Clear(recordCount * recordSize);
+    return recordCount;
+}
+
 bool SignalScatter::RingBuffer::TryBulkEnqueue(ByteSpan const& span)
 {
     uint8_t* data = span.Pointer;
@@ -19,10 +19,36 @@ namespace SignalScatter
 
         void Clear();
         void Clear(int length);
+        // Discards the content and starts over at the beginning of the storage (used when recycling).
+        void Reset();
 
         void Slice(int start, ByteSpan& firstSegmentSpan, ByteSpan& secondSegmentSpan);
         void Slice(int start, int lenght, ByteSpan& firstSegmentSpan, ByteSpan& secondSegmentSpan);
 
+        // Exposes length free bytes at the tail for writing in place. Nothing becomes readable
+        // until Commit publishes the first length bytes of the reservation.
+        bool TryReserve(int length, ByteSpan& firstSegmentSpan, ByteSpan& secondSegmentSpan);
+        void Commit(int length);
+
+        // Exposes up to maxLength readable bytes in place and returns their length. The bytes stay in the
+        // ring until Release consumes length of them; token identifies the read and must be passed back.
+        int Acquire(int maxLength, ByteSpan& firstSegmentSpan, ByteSpan& secondSegmentSpan, int& token);
+        void Release(int token, int length);
+
+        // Moves data between an fd (pipe, socket or file) and ring storage with a single readv/writev
+        // over the free or filled segments, so no intermediate buffer is involved.
+        // Both return the bytes transferred, or -1 with errno set (EAGAIN on a nonblocking fd, ENOBUFS
+        // when the ring is full). EnqueueFromFd returns 0 at end of stream; DequeueToFd returns 0 when
+        // the ring is empty. Transfers may be partial, call again for the rest.
+        int EnqueueFromFd(int fd, int maxBytes);
+        int DequeueToFd(int fd, int maxBytes);
+
+        // Enqueues the longest prefix of spans that fits and returns its span count. A span with a
+        // negative length ends the prefix.
+        int EnqueueBatch(ByteSpan const* spans, int spanCount);
+        // Dequeues up to maxRecordCount whole records of recordSize bytes and returns the record count.
+        int DequeueBatch(uint8_t* destination, int recordSize, int maxRecordCount);
+
         bool TryBulkEnqueue(ByteSpan const& span);
         bool TryBulkDequeue(ByteSpan& span);
 
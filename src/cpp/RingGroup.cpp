@@ -0,0 +1,267 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#include "RingGroup.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#define WORD_BITS 64
+
+namespace
+{
+    int CountTrailingZeros(uint64_t bits)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return (int)index;
+#else
+        return __builtin_ctzll(bits);
+#endif
+    }
+}
+
+SignalScatter::RingGroup::RingGroup(int capacity)
+{
+    _capacity = std::max(capacity, 0);
+    _memberCount = 0;
+    _members.reset(new std::atomic<ConcurrentRingBuffer*>[std::max(_capacity, 1)]);
+
+    // Lowest indices are handed out first.
+    for (int i = _capacity - 1; i >= 0; i--)
+    {
+        _members[i].store(nullptr, std::memory_order_relaxed);
+        _freeMembers.push_back(i);
+    }
+
+    _wordCount = (_capacity + WORD_BITS - 1) / WORD_BITS;
+    int summaryWordCount = (_wordCount + WORD_BITS - 1) / WORD_BITS;
+
+    _readyWords.reset(new std::atomic<uint64_t>[std::max(_wordCount, 1)]);
+    _summaryWords.reset(new std::atomic<uint64_t>[std::max(summaryWordCount, 1)]);
+    for (int i = 0; i < _wordCount; i++)
+    {
+        _readyWords[i].store(0, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < summaryWordCount; i++)
+    {
+        _summaryWords[i].store(0, std::memory_order_relaxed);
+    }
+
+    _nextWord = 0;
+}
+
+SignalScatter::RingGroup::~RingGroup()
+{
+    for (int i = 0; i < _capacity; i++)
+    {
+        ConcurrentRingBuffer* ring = _members[i].load(std::memory_order_acquire);
+        if (ring != nullptr) { ring->SetGroup(nullptr, -1); }
+    }
+}
+
+int SignalScatter::RingGroup::GetCapacity()
+{
+    return _capacity;
+}
+
+int SignalScatter::RingGroup::GetMemberCount()
+{
+    std::lock_guard<std::mutex> lock(_membershipMutex);
+    return _memberCount;
+}
+
+int SignalScatter::RingGroup::Add(ConcurrentRingBuffer* ring)
+{
+    int member;
+    {
+        std::lock_guard<std::mutex> lock(_membershipMutex);
+        if (ring == nullptr || _freeMembers.empty()) { return -1; }
+
+        member = _freeMembers.back();
+        _freeMembers.pop_back();
+        _members[member].store(ring, std::memory_order_release);
+        _memberCount++;
+    }
+
+    ring->SetGroup(this, member);
+
+    // Data enqueued before the ring joined never marked it.
+    if (ring->GetCount() > 0) { MarkReady(member); }
+    return member;
+}
+
+void SignalScatter::RingGroup::Remove(int member)
+{
+    std::lock_guard<std::mutex> lock(_membershipMutex);
+    if (member < 0 || member >= _capacity) { return; }
+
+    ConcurrentRingBuffer* ring = _members[member].exchange(nullptr);
+    if (ring == nullptr) { return; }
+
+    ring->SetGroup(nullptr, -1);
+    _freeMembers.push_back(member);
+    _memberCount--;
+
+    // A stale bit would only cost one empty check, but clear it for the next owner of the index.
+    _readyWords[member / WORD_BITS].fetch_and(~((uint64_t)1 << (member % WORD_BITS)));
+}
+
+SignalScatter::ConcurrentRingBuffer* SignalScatter::RingGroup::GetMember(int member)
+{
+    return (member >= 0 && member < _capacity) ? _members[member].load(std::memory_order_acquire) : nullptr;
+}
+
+void SignalScatter::RingGroup::MarkReady(int member)
+{
+    if (member < 0 || member >= _capacity) { return; }
+
+    int word = member / WORD_BITS;
+    uint64_t bit = (uint64_t)1 << (member % WORD_BITS);
+
+    // Plain load first: while the consumer has not cleared the bit, producers never write the line.
+    if ((_readyWords[word].load(std::memory_order_relaxed) & bit) != 0) { return; }
+
+    _readyWords[word].fetch_or(bit);
+    _summaryWords[word / WORD_BITS].fetch_or((uint64_t)1 << (word % WORD_BITS));
+}
+
+template <typename Visitor>
+void SignalScatter::RingGroup::VisitReady(Visitor visitor)
+{
+    if (_wordCount == 0) { return; }
+
+    // Round-robin over words, so a consumer that stops early does not starve high member indices:
+    // words [startWord, _wordCount) first, then [0, startWord).
+    int startWord = _nextWord;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        int beginWord = (pass == 0) ? startWord : 0;
+        int endWord = (pass == 0) ? _wordCount : startWord;
+
+        for (int summaryIndex = beginWord / WORD_BITS; summaryIndex * WORD_BITS < endWord; summaryIndex++)
+        {
+            std::atomic<uint64_t>& summary = _summaryWords[summaryIndex];
+            uint64_t pendingWords = summary.load(std::memory_order_relaxed);
+
+            // Only the words of this pass; the summary word may straddle startWord.
+            if (summaryIndex == beginWord / WORD_BITS) { pendingWords &= ~(uint64_t)0 << (beginWord % WORD_BITS); }
+            if (summaryIndex == (endWord - 1) / WORD_BITS && endWord % WORD_BITS != 0)
+            {
+                pendingWords &= ((uint64_t)1 << (endWord % WORD_BITS)) - 1;
+            }
+
+            while (pendingWords != 0)
+            {
+                int wordIndex = CountTrailingZeros(pendingWords);
+                pendingWords &= pendingWords - 1;
+
+                int word = summaryIndex * WORD_BITS + wordIndex;
+                uint64_t summaryBit = (uint64_t)1 << wordIndex;
+
+                // Summary before word: a producer setting a member bit afterwards sets the summary again.
+                summary.fetch_and(~summaryBit);
+                uint64_t bits = _readyWords[word].load(std::memory_order_relaxed);
+
+                while (bits != 0)
+                {
+                    int index = CountTrailingZeros(bits);
+                    bits &= bits - 1;
+
+                    int member = word * WORD_BITS + index;
+                    uint64_t bit = (uint64_t)1 << index;
+
+                    // Clear before looking at the ring; pairs with the fence in ConcurrentRingBuffer::NotifyEnqueued.
+                    _readyWords[word].fetch_and(~bit);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                    ConcurrentRingBuffer* ring = _members[member].load(std::memory_order_acquire);
+                    if (ring == nullptr) { continue; }
+
+                    if (!visitor(member, ring))
+                    {
+                        if (bits != 0) { summary.fetch_or(summaryBit); }
+                        _nextWord = word;
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+    _nextWord = (startWord + 1) % _wordCount;
+}
+
+int SignalScatter::RingGroup::Poll(int* members, int maxCount)
+{
+    int count = 0;
+    if (maxCount <= 0) { return 0; }
+
+    VisitReady([&](int member, ConcurrentRingBuffer* ring)
+    {
+        // Polling does not consume, so the ring stays ready.
+        if (ring->GetCount() > 0)
+        {
+            members[count++] = member;
+            MarkReady(member);
+        }
+        return count < maxCount;
+    });
+
+    return count;
+}
+
+int SignalScatter::RingGroup::Drain(int budgetPerRing, int recordSize, uint8_t* buffer, int bufferSize,
+                                    int* members, int* lengths, int maxEntryCount)
+{
+    recordSize = std::max(recordSize, 1);
+    int slotSize = std::min(budgetPerRing, bufferSize) / recordSize * recordSize;
+    if (maxEntryCount <= 0 || slotSize <= 0) { return 0; }
+
+    int slotCount = std::min(maxEntryCount, bufferSize / slotSize);
+
+    // Claim ready members first; their bits stay clear until their ring has been drained below.
+    std::vector<ConcurrentRingBuffer*> rings;
+    VisitReady([&](int member, ConcurrentRingBuffer* ring)
+    {
+        members[rings.size()] = member;
+        rings.push_back(ring);
+        return (int)rings.size() < slotCount;
+    });
+
+    int claimedCount = (int)rings.size();
+    std::vector<int> recordCounts(claimedCount);
+
+    // Each ring is drained into its own slot of the buffer.
+    ThreadPool::GetDefault().ParallelFor(0, claimedCount, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int64_t i = rangeBegin; i < rangeEnd; i++)
+        {
+            recordCounts[i] = rings[i]->DequeueBatch(buffer + i * slotSize, recordSize, slotSize / recordSize);
+            if (rings[i]->GetCount() > 0) { MarkReady(members[i]); }
+        }
+    });
+
+    // Pack the non-empty slots back to back.
+    int entryCount = 0;
+    int offset = 0;
+    for (int i = 0; i < claimedCount; i++)
+    {
+        if (recordCounts[i] == 0) { continue; }
+
+        int length = recordCounts[i] * recordSize;
+        if (offset != i * slotSize) { std::memmove(buffer + offset, buffer + i * slotSize, length); }
+
+        members[entryCount] = members[i];
+        lengths[entryCount] = length;
+        offset += length;
+        entryCount++;
+    }
+
+    return entryCount;
+}
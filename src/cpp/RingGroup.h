@@ -0,0 +1,69 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "ConcurrentRingBuffer.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace SignalScatter
+{
+    // Tracks which of many ConcurrentRingBuffers hold data, so a consumer polling thousands of rings
+    // only touches the non-empty ones.
+    //
+    // Readiness is a two-level bitmap: one bit per member, plus one summary bit per 64-member word.
+    // Producers set their member's bits after an enqueue when the bit is clear (at most once per
+    // empty -> non-empty transition while the consumer is away); Poll and Drain clear a bit before
+    // looking at the ring and set it again if data remains, so no enqueue is missed.
+    //
+    // Poll and Drain are meant for a single consumer thread. Add and Remove may be called from any
+    // thread, but a removed ring may only be destroyed once a running Poll or Drain has returned.
+    class RingGroup
+    {
+    public:
+        RingGroup(int capacity);
+        ~RingGroup();
+
+        int GetCapacity();
+        int GetMemberCount();
+
+        // Returns the member index of the ring, or -1 if the group is full.
+        int Add(ConcurrentRingBuffer* ring);
+        void Remove(int member);
+        ConcurrentRingBuffer* GetMember(int member);
+
+        // Called by ConcurrentRingBuffer after an enqueue.
+        void MarkReady(int member);
+
+        // Writes up to maxCount indices of non-empty members. Returns the number written.
+        int Poll(int* members, int maxCount);
+
+        // Dequeues up to budgetPerRing bytes (whole records of recordSize bytes) from each non-empty member
+        // into buffer, back to back. Entry i is members[i] with lengths[i] bytes. Returns the entry count.
+        // The rings are drained in parallel on the default ThreadPool, each into its own budgetPerRing slot,
+        // so at most bufferSize / budgetPerRing rings are drained per call.
+        int Drain(int budgetPerRing, int recordSize, uint8_t* buffer, int bufferSize,
+                  int* members, int* lengths, int maxEntryCount);
+
+    private:
+        int _capacity;
+        int _memberCount;
+        std::unique_ptr<std::atomic<ConcurrentRingBuffer*>[]> _members;
+        std::vector<int> _freeMembers;
+        std::mutex _membershipMutex;
+
+        int _wordCount;
+        std::unique_ptr<std::atomic<uint64_t>[]> _readyWords;
+        std::unique_ptr<std::atomic<uint64_t>[]> _summaryWords;
+        int _nextWord;
+
+        // Visits ready members round-robin with their bit cleared; visitor returns false to stop and
+        // has to MarkReady members it leaves non-empty.
+        template <typename Visitor>
+        void VisitReady(Visitor visitor);
+    };
+}
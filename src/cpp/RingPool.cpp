@@ -0,0 +1,189 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#include "RingPool.h"
+#include <algorithm>
+
+SignalScatter::RingPool::RingPool(int maxRingCount)
+{
+    _maxRingCount = std::max(maxRingCount, 0);
+    _ringCount = 0;
+    _slots.reset(new Slot[std::max(_maxRingCount, 1)]);
+
+    for (int i = 0; i < _maxRingCount; i++)
+    {
+        // Generations start at 1, so no handle is ever 0.
+        _slots[i].Generation.store(1, std::memory_order_relaxed);
+        _slots[i].InUse.store(false, std::memory_order_relaxed);
+        _slots[i].Concurrent = false;
+        _slots[i].CapacityClass = 0;
+        _slots[i].Ring = nullptr;
+        _slots[i].ConcurrentRing = nullptr;
+    }
+}
+
+SignalScatter::RingPool::~RingPool()
+{
+    for (int i = 0; i < _ringCount; i++)
+    {
+        delete _slots[i].Ring;
+        delete _slots[i].ConcurrentRing;
+    }
+}
+
+int SignalScatter::RingPool::GetMaxRingCount()
+{
+    return _maxRingCount;
+}
+
+int SignalScatter::RingPool::GetRingCount()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _ringCount;
+}
+
+int SignalScatter::RingPool::GetFreeCount(int capacity, bool concurrent)
+{
+    int capacityClass = GetCapacityClass(capacity);
+    if (capacityClass < 0) { return 0; }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (int)_freeSlots[concurrent ? 1 : 0][capacityClass].size();
+}
+
+int SignalScatter::RingPool::GetCapacityClass(int capacity)
+{
+    // Same rounding as the ring constructors: the smallest power of two not below capacity.
+    if (capacity <= 0) { return -1; }
+
+    int capacityClass = 0;
+    while (capacityClass < CapacityClassCount && (1 << capacityClass) < capacity)
+    {
+        capacityClass++;
+    }
+    return (capacityClass < CapacityClassCount) ? capacityClass : -1;
+}
+
+int SignalScatter::RingPool::CreateSlot(int capacityClass, bool concurrent)
+{
+    // Called with the mutex held. Slots are created in order and own their ring for the pool's lifetime.
+    if (_ringCount >= _maxRingCount) { return -1; }
+
+    int slotIndex = _ringCount++;
+    Slot& slot = _slots[slotIndex];
+    slot.Concurrent = concurrent;
+    slot.CapacityClass = capacityClass;
+    if (concurrent)
+    {
+        slot.ConcurrentRing = new ConcurrentRingBuffer(1 << capacityClass);
+    }
+    else
+    {
+        slot.Ring = new RingBuffer(1 << capacityClass);
+    }
+    return slotIndex;
+}
+
+int SignalScatter::RingPool::Preallocate(int capacity, int count, bool concurrent)
+{
+    int capacityClass = GetCapacityClass(capacity);
+    if (capacityClass < 0) { return 0; }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    int created = 0;
+    while (created < count)
+    {
+        int slotIndex = CreateSlot(capacityClass, concurrent);
+        if (slotIndex < 0) { break; }
+
+        _freeSlots[concurrent ? 1 : 0][capacityClass].push_back(slotIndex);
+        created++;
+    }
+    return created;
+}
+
+int64_t SignalScatter::RingPool::AcquireSlot(int capacity, bool concurrent)
+{
+    int capacityClass = GetCapacityClass(capacity);
+    if (capacityClass < 0) { return InvalidHandle; }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    int slotIndex;
+    std::vector<int>& freeSlots = _freeSlots[concurrent ? 1 : 0][capacityClass];
+    if (!freeSlots.empty())
+    {
+        slotIndex = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        slotIndex = CreateSlot(capacityClass, concurrent);
+        if (slotIndex < 0) { return InvalidHandle; }
+    }
+
+    Slot& slot = _slots[slotIndex];
+    slot.InUse.store(true, std::memory_order_release);
+    return ((int64_t)slot.Generation.load(std::memory_order_relaxed) << 32) | (uint32_t)slotIndex;
+}
+
+int64_t SignalScatter::RingPool::Acquire(int capacity)
+{
+    return AcquireSlot(capacity, false);
+}
+
+int64_t SignalScatter::RingPool::AcquireConcurrent(int capacity)
+{
+    return AcquireSlot(capacity, true);
+}
+
+void SignalScatter::RingPool::Release(int64_t handle)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    Slot* slot = Lookup(handle);
+    if (slot == nullptr) { return; }
+
+    // Invalidate outstanding handles before the ring is touched. Generations stay below 2^31 so
+    // handles are never negative.
+    uint32_t generation = slot->Generation.load(std::memory_order_relaxed);
+    slot->Generation.store((generation < 0x7FFFFFFF) ? generation + 1 : 1, std::memory_order_release);
+    slot->InUse.store(false, std::memory_order_release);
+
+    if (slot->Concurrent)
+    {
+        slot->ConcurrentRing->Reset();
+    }
+    else
+    {
+        slot->Ring->Reset();
+    }
+
+    _freeSlots[slot->Concurrent ? 1 : 0][slot->CapacityClass].push_back((int)(uint32_t)handle);
+}
+
+SignalScatter::RingPool::Slot* SignalScatter::RingPool::Lookup(int64_t handle)
+{
+    if (handle <= 0) { return nullptr; }
+
+    uint32_t slotIndex = (uint32_t)handle;
+    uint32_t generation = (uint32_t)(handle >> 32);
+    if (slotIndex >= (uint32_t)_maxRingCount) { return nullptr; }
+
+    Slot& slot = _slots[slotIndex];
+    if (slot.Generation.load(std::memory_order_acquire) != generation || !slot.InUse.load(std::memory_order_acquire)) { return nullptr; }
+    return &slot;
+}
+
+SignalScatter::RingBuffer* SignalScatter::RingPool::GetRingBuffer(int64_t handle)
+{
+    Slot* slot = Lookup(handle);
+    return (slot != nullptr && !slot->Concurrent) ? slot->Ring : nullptr;
+}
+
+SignalScatter::ConcurrentRingBuffer* SignalScatter::RingPool::GetConcurrentRingBuffer(int64_t handle)
+{
+    Slot* slot = Lookup(handle);
+    return (slot != nullptr && slot->Concurrent) ? slot->ConcurrentRing : nullptr;
+}
@@ -0,0 +1,71 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "ConcurrentRingBuffer.h"
+#include "RingBuffer.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace SignalScatter
+{
+    // Recycles ring buffers across connection churn. Rings are kept in free lists per kind and capacity
+    // class (power of two), and a released ring is only reset, so its storage and sequence array are
+    // reused without new allocations, page faults or zero-filling.
+    //
+    // Rings are handed out as integer handles (generation << 32 | slot). Releasing a ring bumps the
+    // generation of its slot, so stale handles resolve to nullptr instead of someone else's ring.
+    // Acquire, Release and Preallocate are thread-safe; lookups are lock-free.
+    class RingPool
+    {
+    public:
+        static constexpr int64_t InvalidHandle = -1;
+
+        // maxRingCount bounds the number of rings the pool ever owns, in use or free.
+        RingPool(int maxRingCount);
+        ~RingPool();
+
+        int GetMaxRingCount();
+        int GetRingCount();
+        int GetFreeCount(int capacity, bool concurrent);
+
+        // Creates rings of the capacity class up front. Returns the number created.
+        int Preallocate(int capacity, int count, bool concurrent);
+
+        // Returns a handle to an empty ring with at least capacity bytes, or InvalidHandle when the pool is full.
+        int64_t Acquire(int capacity);
+        int64_t AcquireConcurrent(int capacity);
+        void Release(int64_t handle);
+
+        RingBuffer* GetRingBuffer(int64_t handle);
+        ConcurrentRingBuffer* GetConcurrentRingBuffer(int64_t handle);
+
+    private:
+        static constexpr int CapacityClassCount = 31;
+
+        struct Slot
+        {
+            std::atomic<uint32_t> Generation;
+            std::atomic<bool> InUse;
+            bool Concurrent;
+            int CapacityClass;
+            RingBuffer* Ring;
+            ConcurrentRingBuffer* ConcurrentRing;
+        };
+
+        int _maxRingCount;
+        int _ringCount;
+        std::unique_ptr<Slot[]> _slots;
+        std::vector<int> _freeSlots[2][CapacityClassCount];
+        std::mutex _mutex;
+
+        static int GetCapacityClass(int capacity);
+        int CreateSlot(int capacityClass, bool concurrent);
+        int64_t AcquireSlot(int capacity, bool concurrent);
+        Slot* Lookup(int64_t handle);
+    };
+}
@@ -0,0 +1,269 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#include "ScatterEngine.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Inbound rings only carry references, so they need room for at least one.
+#define REFERENCE_SIZE 8
+
+// Source of a claimed message slot whose payload did not fit in the arena.
+#define DROPPED_SOURCE UINT32_MAX
+
+SignalScatter::ScatterEngine::ScatterEngine(uint32_t pointCount, int inboxCapacity, uint32_t arenaSize, uint32_t maxMessageCount)
+    : _destinationCursors(pointCount)
+{
+    _pointCount = pointCount;
+
+    // Ring sizes are powers of two of at least REFERENCE_SIZE bytes, so 8-byte references never straddle the end.
+    inboxCapacity = std::max(inboxCapacity, REFERENCE_SIZE);
+    _inboxes.resize(pointCount);
+    for (uint32_t i = 0; i < pointCount; i++)
+    {
+        _inboxes[i] = new ConcurrentRingBuffer(inboxCapacity);
+    }
+
+    _arena = new uint8_t[arenaSize];
+    _arenaSize = arenaSize;
+    _arenaPosition.store(0, std::memory_order_relaxed);
+
+    _messageSources.resize(maxMessageCount);
+    _messageReferences.resize(maxMessageCount);
+    _messageCount.store(0, std::memory_order_relaxed);
+
+    _droppedCount = 0;
+}
+
+SignalScatter::ScatterEngine::~ScatterEngine()
+{
+    for (ConcurrentRingBuffer* inbox : _inboxes)
+    {
+        delete inbox;
+    }
+    delete[] _arena;
+}
+
+uint32_t SignalScatter::ScatterEngine::GetPointCount()
+{
+    return _pointCount;
+}
+
+uint32_t SignalScatter::ScatterEngine::GetMessageCount()
+{
+    // Failed publishes may have pushed the counter past the table size.
+    return std::min(_messageCount.load(std::memory_order_acquire), (uint32_t)_messageSources.size());
+}
+
+uint32_t SignalScatter::ScatterEngine::GetDroppedCount()
+{
+    return _droppedCount;
+}
+
+SignalScatter::ConcurrentRingBuffer* SignalScatter::ScatterEngine::GetInbox(uint32_t point)
+{
+    return (point < _pointCount) ? _inboxes[point] : nullptr;
+}
+
+bool SignalScatter::ScatterEngine::Publish(uint32_t source, ByteSpan const& payload)
+{
+    if (source >= _pointCount || payload.Length < 0) { return false; }
+
+    // Payloads start on 8-byte boundaries.
+    uint32_t length = (uint32_t)payload.Length;
+    uint32_t alignedLength = (length + 7) & ~7u;
+
+    // Claim the table slot first, so a full table does not consume arena space.
+    uint32_t index = _messageCount.fetch_add(1, std::memory_order_relaxed);
+    if (index >= _messageSources.size()) { return false; }
+
+    // The arena only advances when the payload fits.
+    uint64_t offset = _arenaPosition.load(std::memory_order_relaxed);
+    do
+    {
+        if (alignedLength > _arenaSize || offset > _arenaSize - alignedLength)
+        {
+            _messageSources[index] = DROPPED_SOURCE;
+            return false;
+        }
+    }
+    while (!_arenaPosition.compare_exchange_weak(offset, offset + alignedLength, std::memory_order_relaxed));
+
+    std::memcpy(_arena + offset, payload.Pointer, length);
+    _messageSources[index] = source;
+    _messageReferences[index] = ((uint64_t)offset << 32) | length;
+    return true;
+}
+
+uint32_t SignalScatter::ScatterEngine::Scatter(uint32_t k, uint32_t const* neighborIdMatrix)
+{
+    if (k == 0)
+    {
+        // Stride 0 selects CSR rows in ScatterRows, so pass empty rows explicitly.
+        std::vector<uint32_t> emptyOffsets(_pointCount + 1, 0);
+        return ScatterRows(0, emptyOffsets.data(), neighborIdMatrix);
+    }
+
+    return ScatterRows(k, nullptr, neighborIdMatrix);
+}
+
+uint32_t SignalScatter::ScatterEngine::Scatter(uint32_t const* neighborOffsets, uint32_t const* neighborIds)
+{
+    return ScatterRows(0, neighborOffsets, neighborIds);
+}
+
+void SignalScatter::ScatterEngine::GroupBySource(uint32_t messageCount)
+{
+    _sourceOffsets.assign(_pointCount + 1, 0);
+    _sourceMessages.resize(messageCount);
+
+    for (uint32_t i = 0; i < messageCount; i++)
+    {
+        if (_messageSources[i] == DROPPED_SOURCE) { continue; }
+        _sourceOffsets[_messageSources[i] + 1]++;
+    }
+    for (uint32_t i = 0; i < _pointCount; i++)
+    {
+        _sourceOffsets[i + 1] += _sourceOffsets[i];
+    }
+
+    // Publish order is kept within a source.
+    std::vector<uint32_t> cursors(_sourceOffsets.begin(), _sourceOffsets.end() - 1);
+    for (uint32_t i = 0; i < messageCount; i++)
+    {
+        if (_messageSources[i] == DROPPED_SOURCE) { continue; }
+        _sourceMessages[cursors[_messageSources[i]]++] = i;
+    }
+}
+
+uint32_t SignalScatter::ScatterEngine::ScatterRows(uint32_t stride, uint32_t const* neighborOffsets, uint32_t const* neighborIds)
+{
+    uint32_t pointCount = _pointCount;
+    uint32_t messageCount = GetMessageCount();
+
+    GroupBySource(messageCount);
+
+    ThreadPool& pool = ThreadPool::GetDefault();
+
+    // Invert the neighbor lists: count the messages each destination receives ...
+    for (uint32_t i = 0; i < pointCount; i++)
+    {
+        _destinationCursors[i].store(0, std::memory_order_relaxed);
+    }
+
+    pool.ParallelFor(0, pointCount, 64, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (uint32_t source = (uint32_t)rangeBegin; source < (uint32_t)rangeEnd; source++)
+        {
+            uint32_t sourceMessageCount = _sourceOffsets[source + 1] - _sourceOffsets[source];
+            if (sourceMessageCount == 0) { continue; }
+
+            size_t begin = (stride > 0) ? (size_t)source * stride : neighborOffsets[source];
+            size_t end = (stride > 0) ? begin + stride : neighborOffsets[source + 1];
+            for (size_t i = begin; i < end; i++)
+            {
+                uint32_t destination = neighborIds[i];
+                if (destination == source || destination >= pointCount) { continue; }
+                _destinationCursors[destination].fetch_add(sourceMessageCount, std::memory_order_relaxed);
+            }
+        }
+    });
+
+    _destinationOffsets.assign(pointCount + 1, 0);
+    for (uint32_t i = 0; i < pointCount; i++)
+    {
+        uint32_t count = _destinationCursors[i].load(std::memory_order_relaxed);
+        _destinationOffsets[i + 1] = _destinationOffsets[i] + count;
+        _destinationCursors[i].store(_destinationOffsets[i], std::memory_order_relaxed);
+    }
+    _destinationMessages.resize(_destinationOffsets[pointCount]);
+
+    // ... then fill the per-destination message lists.
+    pool.ParallelFor(0, pointCount, 64, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (uint32_t source = (uint32_t)rangeBegin; source < (uint32_t)rangeEnd; source++)
+        {
+            uint32_t const* messages = _sourceMessages.data() + _sourceOffsets[source];
+            uint32_t sourceMessageCount = _sourceOffsets[source + 1] - _sourceOffsets[source];
+            if (sourceMessageCount == 0) { continue; }
+
+            size_t begin = (stride > 0) ? (size_t)source * stride : neighborOffsets[source];
+            size_t end = (stride > 0) ? begin + stride : neighborOffsets[source + 1];
+            for (size_t i = begin; i < end; i++)
+            {
+                uint32_t destination = neighborIds[i];
+                if (destination == source || destination >= pointCount) { continue; }
+
+                uint32_t slot = _destinationCursors[destination].fetch_add(sourceMessageCount, std::memory_order_relaxed);
+                std::copy(messages, messages + sourceMessageCount, _destinationMessages.begin() + slot);
+            }
+        }
+    });
+
+    // Fan out one destination per iteration: every inbox has a single producer and its
+    // references are enqueued back to back in publish order.
+    std::atomic<uint32_t> deliveredCount(0);
+
+    pool.ParallelFor(0, pointCount, 16, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        uint32_t delivered = 0;
+
+        for (uint32_t destination = (uint32_t)rangeBegin; destination < (uint32_t)rangeEnd; destination++)
+        {
+            uint32_t* begin = _destinationMessages.data() + _destinationOffsets[destination];
+            uint32_t* end = _destinationMessages.data() + _destinationOffsets[destination + 1];
+            std::sort(begin, end);
+
+            ConcurrentRingBuffer* inbox = _inboxes[destination];
+            for (uint32_t* message = begin; message < end; message++)
+            {
+                uint64_t reference = _messageReferences[*message];
+                ByteSpan span((uint8_t*)&reference, REFERENCE_SIZE);
+                if (!inbox->TryBulkEnqueueByte8(span)) { break; }
+                delivered++;
+            }
+        }
+
+        deliveredCount.fetch_add(delivered, std::memory_order_relaxed);
+    });
+
+    uint32_t delivered = deliveredCount.load(std::memory_order_relaxed);
+    _droppedCount = _destinationOffsets[pointCount] - delivered;
+    return delivered;
+}
+
+bool SignalScatter::ScatterEngine::TryReceive(uint32_t point, ByteSpan& payload)
+{
+    // Each inbox has a single consumer, so an empty check up front is enough.
+    if (point >= _pointCount || _inboxes[point]->GetCount() < REFERENCE_SIZE) { return false; }
+
+    uint64_t reference = 0;
+    ByteSpan span((uint8_t*)&reference, REFERENCE_SIZE);
+    if (!_inboxes[point]->TryBulkDequeueByte8(span)) { return false; }
+
+    payload.Pointer = _arena + (reference >> 32);
+    payload.Length = (int)(reference & 0xFFFFFFFF);
+    return true;
+}
+
+void SignalScatter::ScatterEngine::ResetFrame()
+{
+    // Unread references would point into the recycled arena.
+    ThreadPool::GetDefault().ParallelFor(0, _pointCount, 64, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        uint64_t reference;
+        ByteSpan span((uint8_t*)&reference, REFERENCE_SIZE);
+
+        for (int64_t point = rangeBegin; point < rangeEnd; point++)
+        {
+            while (_inboxes[point]->GetCount() >= REFERENCE_SIZE && _inboxes[point]->TryBulkDequeueByte8(span)) {}
+        }
+    });
+
+    _arenaPosition.store(0, std::memory_order_relaxed);
+    _messageCount.store(0, std::memory_order_relaxed);
+}
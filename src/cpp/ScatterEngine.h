@@ -0,0 +1,71 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "ConcurrentRingBuffer.h"
+#include "Span.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace SignalScatter
+{
+    // Routes the messages published by each point to the inbound rings of its neighbors.
+    // Payloads are copied once into a per-frame arena; inbound rings only carry 8-byte references
+    // (arena offset and length), so a message sent to k neighbors is stored once. References stay
+    // valid until ResetFrame, which also discards whatever the inboxes have not consumed yet.
+    //
+    // A frame is: Publish (any thread), then Scatter, then TryReceive per point, then ResetFrame.
+    // Point indices double as the neighbor IDs, i.e. Point::Id must equal the position in the cloud.
+    class ScatterEngine
+    {
+    public:
+        ScatterEngine(uint32_t pointCount, int inboxCapacity, uint32_t arenaSize, uint32_t maxMessageCount);
+        ~ScatterEngine();
+
+        uint32_t GetPointCount();
+        uint32_t GetMessageCount();
+        // Number of references the last Scatter could not enqueue because an inbox was full.
+        uint32_t GetDroppedCount();
+        ConcurrentRingBuffer* GetInbox(uint32_t point);
+
+        // Copies the payload into the arena. Thread-safe; fails when the arena or the message table is full.
+        // A payload that does not fit in the arena still uses up its table slot, but no arena space.
+        bool Publish(uint32_t source, ByteSpan const& payload);
+
+        // Fans out every published message to the neighbors of its source, skipping the source itself
+        // and InvalidNeighborId entries. Neighbor lists are either a pointCount x k matrix or CSR rows.
+        // Returns the number of references delivered.
+        uint32_t Scatter(uint32_t k, uint32_t const* neighborIdMatrix);
+        uint32_t Scatter(uint32_t const* neighborOffsets, uint32_t const* neighborIds);
+
+        // Dequeues the next reference of the point's inbox and resolves it to the payload in the arena.
+        bool TryReceive(uint32_t point, ByteSpan& payload);
+
+        void ResetFrame();
+
+    private:
+        uint32_t _pointCount;
+        std::vector<ConcurrentRingBuffer*> _inboxes;
+
+        uint8_t* _arena;
+        uint32_t _arenaSize;
+        std::atomic<uint64_t> _arenaPosition;
+
+        std::vector<uint32_t> _messageSources;
+        std::vector<uint64_t> _messageReferences;
+        std::atomic<uint32_t> _messageCount;
+
+        // Messages grouped by source, and the inverted (per destination) lists of message indices.
+        std::vector<uint32_t> _sourceOffsets;
+        std::vector<uint32_t> _sourceMessages;
+        std::vector<uint32_t> _destinationOffsets;
+        std::vector<uint32_t> _destinationMessages;
+        std::vector<std::atomic<uint32_t>> _destinationCursors;
+        uint32_t _droppedCount;
+
+        uint32_t ScatterRows(uint32_t stride, uint32_t const* neighborOffsets, uint32_t const* neighborIds);
+        void GroupBySource(uint32_t messageCount);
+    };
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace SignalScatter
+{
+    // 64-bit composite sort key: order-preserving distance bits in the high half and the
+    // neighbor ID in the low half. Sorting keys as unsigned integers orders by distance,
+    // then by ID, and moves a single word instead of a key and a value.
+    const uint64_t InvalidSortKey = 0xFFFFFFFFFFFFFFFF;
+
+    // Maps a float to bits whose unsigned order matches the float order.
+    inline uint32_t EncodeDistanceBits(float distance)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &distance, sizeof(bits));
+        return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+    }
+
+    inline float DecodeDistanceBits(uint32_t bits)
+    {
+        bits = (bits & 0x80000000) ? (bits & 0x7FFFFFFF) : ~bits;
+        float distance;
+        std::memcpy(&distance, &bits, sizeof(distance));
+        return distance;
+    }
+
+    inline uint64_t MakeSortKey(float squaredDistance, uint32_t id)
+    {
+        return ((uint64_t)EncodeDistanceBits(squaredDistance) << 32) | id;
+    }
+
+    inline float GetSortKeyDistance(uint64_t key)
+    {
+        return DecodeDistanceBits((uint32_t)(key >> 32));
+    }
+
+    inline uint32_t GetSortKeyId(uint64_t key)
+    {
+        return (uint32_t)key;
+    }
+
+    // 32-bit quantized key: a monotonic 16-bit distance code in the high half and a 16-bit column index
+    // in the low half, so one pair moves 4 bytes. Codes are linear in distance (not squared distance),
+    // giving maxDistance / 65534 resolution over the whole range; 0xFFFF marks pairs beyond maxDistance.
+    // Every key at or above QuantizedOutOfRangeKey is out of range. Column indices stop at 0xFFFE so an
+    // out-of-range key never equals InvalidQuantizedKey.
+    const uint32_t InvalidQuantizedKey = 0xFFFFFFFF;
+    const uint32_t QuantizedOutOfRangeKey = 0xFFFF0000;
+    const uint32_t QuantizedMaxColumnCount = 0xFFFF;
+    const uint32_t QuantizedDistanceStepCount = 0xFFFE;
+
+    inline uint32_t MakeQuantizedKey(float squaredDistance, float maxDistance, uint32_t index)
+    {
+        uint32_t distanceCode = 0xFFFF;
+        if (squaredDistance <= maxDistance * maxDistance)
+        {
+            distanceCode = (uint32_t)(std::sqrt(squaredDistance) * (QuantizedDistanceStepCount / maxDistance) + 0.5f);
+            distanceCode = (distanceCode < QuantizedDistanceStepCount) ? distanceCode : QuantizedDistanceStepCount;
+        }
+        return (distanceCode << 16) | (index & 0xFFFF);
+    }
+
+    inline float GetQuantizedKeyDistance(uint32_t key, float maxDistance)
+    {
+        return (float)(key >> 16) * (maxDistance / QuantizedDistanceStepCount);
+    }
+
+    inline uint32_t GetQuantizedKeyIndex(uint32_t key)
+    {
+        return key & 0xFFFF;
+    }
+}
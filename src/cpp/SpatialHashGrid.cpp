@@ -0,0 +1,241 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+//
+// References
+//   - M. Teschner et al., "Optimized Spatial Hashing for Collision Detection of Deformable Objects", 2003
+//
+#include "SpatialHashGrid.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+SignalScatter::SpatialHashGrid::SpatialHashGrid(float cellSize)
+{
+    SetCellSize(cellSize);
+    _pointCount = 0;
+    _bucketMask = 0;
+}
+
+SignalScatter::SpatialHashGrid::~SpatialHashGrid()
+{
+}
+
+float SignalScatter::SpatialHashGrid::GetCellSize()
+{
+    return _cellSize;
+}
+
+void SignalScatter::SpatialHashGrid::SetCellSize(float cellSize)
+{
+    _cellSize = cellSize;
+    _inverseCellSize = 1.0f / cellSize;
+}
+
+int SignalScatter::SpatialHashGrid::GetPointCount()
+{
+    return _pointCount;
+}
+
+uint32_t const* SignalScatter::SpatialHashGrid::GetNeighborOffsets()
+{
+    return _neighborOffsets.data();
+}
+
+float const* SignalScatter::SpatialHashGrid::GetNeighborDistances()
+{
+    return _neighborDistances.data();
+}
+
+uint32_t const* SignalScatter::SpatialHashGrid::GetNeighborIds()
+{
+    return _neighborIds.data();
+}
+
+int SignalScatter::SpatialHashGrid::GetCellCoordinate(float position)
+{
+    return (int)std::floor(position * _inverseCellSize);
+}
+
+uint32_t SignalScatter::SpatialHashGrid::GetBucket(int cellX, int cellY, int cellZ)
+{
+    uint32_t hash = ((uint32_t)cellX * 73856093u) ^ ((uint32_t)cellY * 19349663u) ^ ((uint32_t)cellZ * 83492791u);
+    return hash & _bucketMask;
+}
+
+void SignalScatter::SpatialHashGrid::Build(Point const* points, int count)
+{
+    _pointCount = count;
+
+    int power = (count > 1) ? (int)std::ceil(std::log2(count)) + 1 : 1;
+    uint32_t bucketCount = 1u << power; // Bucket count should be a power of two.
+    _bucketMask = bucketCount - 1;
+
+    _bucketStart.assign(bucketCount + 1, 0);
+    _pointBucket.resize(count);
+    _indices.resize(count);
+    _positionX.resize(count);
+    _positionY.resize(count);
+    _positionZ.resize(count);
+    _ids.resize(count);
+
+    std::vector<std::atomic<uint32_t>> bucketCursors(bucketCount);
+
+    ThreadPool::GetDefault().ParallelFor(0, count, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int i = (int)rangeBegin; i < (int)rangeEnd; i++)
+        {
+            uint32_t bucket = GetBucket(GetCellCoordinate(points[i].PositionX),
+                                        GetCellCoordinate(points[i].PositionY),
+                                        GetCellCoordinate(points[i].PositionZ));
+            _pointBucket[i] = bucket;
+            bucketCursors[bucket].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    // Exclusive prefix sum turns the counts into bucket start offsets.
+    for (uint32_t bucket = 0; bucket < bucketCount; bucket++)
+    {
+        _bucketStart[bucket + 1] = _bucketStart[bucket] + bucketCursors[bucket].load(std::memory_order_relaxed);
+        bucketCursors[bucket].store(_bucketStart[bucket], std::memory_order_relaxed);
+    }
+
+    ThreadPool::GetDefault().ParallelFor(0, count, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int i = (int)rangeBegin; i < (int)rangeEnd; i++)
+        {
+            uint32_t slot = bucketCursors[_pointBucket[i]].fetch_add(1, std::memory_order_relaxed);
+            _indices[slot] = i;
+            _positionX[slot] = points[i].PositionX;
+            _positionY[slot] = points[i].PositionY;
+            _positionZ[slot] = points[i].PositionZ;
+            _ids[slot] = points[i].Id;
+        }
+    });
+}
+
+// Counts the neighbors of the point at the given slot and, when the output arrays are not null, writes them.
+uint32_t SignalScatter::SpatialHashGrid::VisitNeighbors(uint32_t slot, float radius, std::vector<uint32_t>& visitedBuckets,
+                                                         float* distances, uint32_t* ids)
+{
+    float x = _positionX[slot];
+    float y = _positionY[slot];
+    float z = _positionZ[slot];
+    float squaredRadius = radius * radius;
+
+    // QueryRadius keeps the cell size equal to the radius, so the neighbors lie in the adjacent cells.
+    int cellX = GetCellCoordinate(x);
+    int cellY = GetCellCoordinate(y);
+    int cellZ = GetCellCoordinate(z);
+
+    // Several cells can hash to the same bucket, so each bucket is scanned once per query.
+    visitedBuckets.clear();
+    for (int dz = -1; dz <= 1; dz++)
+    for (int dy = -1; dy <= 1; dy++)
+    for (int dx = -1; dx <= 1; dx++)
+    {
+        visitedBuckets.push_back(GetBucket(cellX + dx, cellY + dy, cellZ + dz));
+    }
+    std::sort(visitedBuckets.begin(), visitedBuckets.end());
+    visitedBuckets.erase(std::unique(visitedBuckets.begin(), visitedBuckets.end()), visitedBuckets.end());
+
+    uint32_t found = 0;
+
+    for (uint32_t bucket : visitedBuckets)
+    {
+        uint32_t begin = _bucketStart[bucket];
+        uint32_t end = _bucketStart[bucket + 1];
+
+        for (uint32_t other = begin; other < end; other++)
+        {
+            float ox = _positionX[other] - x;
+            float oy = _positionY[other] - y;
+            float oz = _positionZ[other] - z;
+            float squaredDistance = ox * ox + oy * oy + oz * oz;
+
+            if (squaredDistance <= squaredRadius)
+            {
+                if (distances != nullptr)
+                {
+                    distances[found] = squaredDistance;
+                    ids[found] = _ids[other];
+                }
+                found++;
+            }
+        }
+    }
+
+    return found;
+}
+
+void SignalScatter::SpatialHashGrid::QueryRadius(float radius, bool sorted)
+{
+    int count = _pointCount;
+
+    // Cells as wide as the radius keep every query to 27 cells.
+    if (radius > 0.0f && radius != _cellSize)
+    {
+        std::vector<Point> points(count);
+        for (int slot = 0; slot < count; slot++)
+        {
+            Point& point = points[_indices[slot]];
+            point.Id = _ids[slot];
+            point.PositionX = _positionX[slot];
+            point.PositionY = _positionY[slot];
+            point.PositionZ = _positionZ[slot];
+        }
+
+        SetCellSize(radius);
+        Build(points.data(), count);
+    }
+
+    _neighborOffsets.assign(count + 1, 0);
+
+    // Queries are issued in bucket order for locality; rows are stored by input index.
+    ThreadPool::GetDefault().ParallelFor(0, count, 64, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        std::vector<uint32_t> visitedBuckets;
+
+        for (int slot = (int)rangeBegin; slot < (int)rangeEnd; slot++)
+        {
+            _neighborOffsets[_indices[slot] + 1] = VisitNeighbors(slot, radius, visitedBuckets, nullptr, nullptr);
+        }
+    });
+
+    for (int i = 0; i < count; i++)
+    {
+        _neighborOffsets[i + 1] += _neighborOffsets[i];
+    }
+
+    _neighborDistances.resize(_neighborOffsets[count]);
+    _neighborIds.resize(_neighborOffsets[count]);
+
+    ThreadPool::GetDefault().ParallelFor(0, count, 64, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        std::vector<uint32_t> visitedBuckets;
+        std::vector<std::pair<float, uint32_t>> pairs;
+
+        for (int slot = (int)rangeBegin; slot < (int)rangeEnd; slot++)
+        {
+            uint32_t offset = _neighborOffsets[_indices[slot]];
+            float* distances = _neighborDistances.data() + offset;
+            uint32_t* ids = _neighborIds.data() + offset;
+            uint32_t found = VisitNeighbors(slot, radius, visitedBuckets, distances, ids);
+
+            if (sorted && found > 1)
+            {
+                pairs.resize(found);
+                for (uint32_t i = 0; i < found; i++) { pairs[i] = std::make_pair(distances[i], ids[i]); }
+                std::sort(pairs.begin(), pairs.end());
+                for (uint32_t i = 0; i < found; i++)
+                {
+                    distances[i] = pairs[i].first;
+                    ids[i] = pairs[i].second;
+                }
+            }
+        }
+    });
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "Point.h"
+#include <cstdint>
+#include <vector>
+
+namespace SignalScatter
+{
+    // Uniform grid hashed into a power-of-two bucket table. Points are kept in bucket order
+    // (counting sort) as SoA arrays so that a radius query scans contiguous memory.
+    // The cell size is tied to the query radius: QueryRadius re-buckets the points when the radius
+    // differs from the cell size, so every query visits 27 cells. Build with the radius as cell size
+    // to skip that step.
+    class SpatialHashGrid
+    {
+    public:
+        SpatialHashGrid(float cellSize);
+        ~SpatialHashGrid();
+
+        float GetCellSize();
+        void SetCellSize(float cellSize);
+        int GetPointCount();
+
+        // Rebuilds the grid from scratch. Intended to be called once per frame.
+        void Build(Point const* points, int count);
+
+        // Finds every point within the radius of each point of the last Build, the point itself included.
+        // Results are stored in CSR layout indexed by the position of the query point in the input array;
+        // neighbor IDs are Point::Id values. When sorted is true each row is ordered by squared distance.
+        void QueryRadius(float radius, bool sorted);
+
+        uint32_t const* GetNeighborOffsets();
+        float const* GetNeighborDistances();
+        uint32_t const* GetNeighborIds();
+
+    private:
+        float _cellSize;
+        float _inverseCellSize;
+        int _pointCount;
+        uint32_t _bucketMask;
+
+        std::vector<uint32_t> _bucketStart;
+        std::vector<uint32_t> _pointBucket;
+        std::vector<uint32_t> _indices;
+        std::vector<float> _positionX;
+        std::vector<float> _positionY;
+        std::vector<float> _positionZ;
+        std::vector<uint32_t> _ids;
+
+        std::vector<uint32_t> _neighborOffsets;
+        std::vector<float> _neighborDistances;
+        std::vector<uint32_t> _neighborIds;
+
+        int GetCellCoordinate(float position);
+        uint32_t GetBucket(int cellX, int cellY, int cellZ);
+        uint32_t VisitNeighbors(uint32_t slot, float radius, std::vector<uint32_t>& visitedBuckets,
+                                float* distances, uint32_t* ids);
+    };
+}
@@ -0,0 +1,255 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#include "ThreadPool.h"
+#include <algorithm>
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(_WIN64)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Failed steal attempts before a waiting thread starts yielding.
+#define WAIT_SPIN_COUNT 64
+
+namespace
+{
+    thread_local SignalScatter::ThreadPool* CurrentPool = nullptr;
+    thread_local int CurrentWorkerIndex = -1;
+
+    std::atomic<SignalScatter::ThreadPool*> DefaultPool(nullptr);
+}
+
+SignalScatter::ThreadPool::ThreadPool(int workerCount, bool pinThreads, int firstCpu)
+{
+    int cpuCount = std::max(1, (int)std::thread::hardware_concurrency());
+    if (workerCount <= 0) { workerCount = cpuCount - 1; }
+
+    _workerCount = workerCount;
+    _queues.reset(new WorkerQueue[std::max(1, workerCount)]);
+    _queuedTaskCount = 0;
+    _sleepingCount = 0;
+    _nextQueue = 0;
+    _stopping = false;
+
+    for (int i = 0; i < workerCount; i++)
+    {
+        int cpu = (firstCpu + i) % cpuCount;
+        _workers.emplace_back([this, i, pinThreads, cpu]()
+        {
+            if (pinThreads) { PinCurrentThread(cpu); }
+            WorkerMain(i);
+        });
+    }
+}
+
+SignalScatter::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stopping = true;
+    }
+    _wakeCondition.notify_all();
+
+    for (std::thread& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+int SignalScatter::ThreadPool::GetWorkerCount()
+{
+    return _workerCount;
+}
+
+int SignalScatter::ThreadPool::GetConcurrency()
+{
+    return _workerCount + 1;
+}
+
+SignalScatter::ThreadPool& SignalScatter::ThreadPool::GetDefault()
+{
+    ThreadPool* pool = DefaultPool.load(std::memory_order_acquire);
+    if (pool != nullptr) { return *pool; }
+
+    static ThreadPool builtInPool;
+    return builtInPool;
+}
+
+void SignalScatter::ThreadPool::SetDefault(ThreadPool* pool)
+{
+    DefaultPool.store(pool, std::memory_order_release);
+}
+
+void SignalScatter::ThreadPool::PinCurrentThread(int cpu)
+{
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(_WIN64)
+    if (cpu < 64) { SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu); }
+#elif defined(__linux__)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+#else
+    (void)cpu;
+#endif
+}
+
+int SignalScatter::ThreadPool::GetCurrentWorkerIndex()
+{
+    return (CurrentPool == this) ? CurrentWorkerIndex : -1;
+}
+
+void SignalScatter::ThreadPool::WorkerMain(int index)
+{
+    CurrentPool = this;
+    CurrentWorkerIndex = index;
+
+    while (true)
+    {
+        Task task;
+        if (TryPop(index, task) || TrySteal(index, task))
+        {
+            Execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleepingCount.fetch_add(1);
+        _wakeCondition.wait(lock, [this]() { return _stopping.load() || _queuedTaskCount.load() > 0; });
+        _sleepingCount.fetch_sub(1);
+
+        if (_stopping.load()) { return; }
+    }
+}
+
+bool SignalScatter::ThreadPool::TryPop(int index, Task& task)
+{
+    WorkerQueue& queue = _queues[index];
+    std::lock_guard<std::mutex> lock(queue.Mutex);
+    if (queue.Tasks.empty()) { return false; }
+
+    task = std::move(queue.Tasks.back());
+    queue.Tasks.pop_back();
+    _queuedTaskCount.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool SignalScatter::ThreadPool::TrySteal(int thief, Task& task)
+{
+    // Oldest tasks are taken first; with range splitting those are the largest pieces.
+    for (int i = 1; i <= _workerCount; i++)
+    {
+        int victim = (thief + i) % _workerCount;
+        if (victim == thief) { continue; }
+
+        WorkerQueue& queue = _queues[victim];
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+        if (queue.Tasks.empty()) { continue; }
+
+        task = std::move(queue.Tasks.front());
+        queue.Tasks.pop_front();
+        _queuedTaskCount.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    return false;
+}
+
+void SignalScatter::ThreadPool::Execute(Task& task)
+{
+    task.Function();
+    task.Group->_pendingCount.fetch_sub(1, std::memory_order_release);
+}
+
+void SignalScatter::ThreadPool::Submit(TaskGroup& group, std::function<void()> task)
+{
+    if (_workerCount == 0)
+    {
+        task();
+        return;
+    }
+
+    group._pendingCount.fetch_add(1, std::memory_order_relaxed);
+
+    // Workers push onto their own deque; other threads spread tasks round-robin.
+    int index = GetCurrentWorkerIndex();
+    if (index < 0) { index = (int)(_nextQueue.fetch_add(1, std::memory_order_relaxed) % (uint32_t)_workerCount); }
+
+    {
+        WorkerQueue& queue = _queues[index];
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+        queue.Tasks.push_back(Task { std::move(task), &group });
+    }
+
+    // Pairs with the sleeping count increment in WorkerMain: either the worker sees the
+    // queued task before it waits, or this thread sees the sleeper and wakes it.
+    _queuedTaskCount.fetch_add(1);
+    if (_sleepingCount.load() > 0)
+    {
+        { std::lock_guard<std::mutex> lock(_sleepMutex); }
+        _wakeCondition.notify_one();
+    }
+}
+
+void SignalScatter::ThreadPool::Wait(TaskGroup& group)
+{
+    int index = GetCurrentWorkerIndex();
+    int spinCount = 0;
+
+    while (!group.IsDone())
+    {
+        Task task;
+        if ((index >= 0 && TryPop(index, task)) || TrySteal(index, task))
+        {
+            Execute(task);
+            spinCount = 0;
+        }
+        else if (++spinCount > WAIT_SPIN_COUNT)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void SignalScatter::ThreadPool::SplitRange(int64_t begin, int64_t end, int64_t grainSize,
+                                           std::function<void(int64_t, int64_t)> const& body, TaskGroup& group)
+{
+    while (end - begin > grainSize)
+    {
+        int64_t middle = begin + (end - begin) / 2;
+        Submit(group, [this, middle, end, grainSize, &body, &group]()
+        {
+            SplitRange(middle, end, grainSize, body, group);
+        });
+        end = middle;
+    }
+
+    body(begin, end);
+}
+
+void SignalScatter::ThreadPool::ParallelFor(int64_t begin, int64_t end, int64_t grainSize,
+                                            std::function<void(int64_t, int64_t)> const& body)
+{
+    if (end <= begin) { return; }
+
+    if (grainSize <= 0)
+    {
+        grainSize = std::max<int64_t>(1, (end - begin) / (4 * (int64_t)GetConcurrency()));
+    }
+
+    if (_workerCount == 0 || end - begin <= grainSize)
+    {
+        body(begin, end);
+        return;
+    }
+
+    TaskGroup group;
+    SplitRange(begin, end, grainSize, body, group);
+    Wait(group);
+}
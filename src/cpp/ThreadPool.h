@@ -0,0 +1,94 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SignalScatter
+{
+    // Counts the tasks submitted through it that have not finished yet.
+    class TaskGroup
+    {
+    public:
+        TaskGroup() : _pendingCount(0) {}
+
+        bool IsDone() const { return _pendingCount.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class ThreadPool;
+        std::atomic<int> _pendingCount;
+    };
+
+    // Work-stealing thread pool shared by the parallel stages.
+    // Each worker owns a deque: it pops its own tasks LIFO and steals from the other end of
+    // the other deques when it runs dry. Threads that wait on a TaskGroup run queued tasks
+    // instead of blocking, so stages can nest and the calling thread takes part in the work.
+    class ThreadPool
+    {
+    public:
+        // workerCount 0 uses one worker per hardware thread minus the calling thread.
+        // With pinThreads, worker i is bound to CPU (firstCpu + i) modulo the CPU count.
+        ThreadPool(int workerCount = 0, bool pinThreads = false, int firstCpu = 0);
+        ~ThreadPool();
+
+        int GetWorkerCount();
+        // Number of threads that can run tasks at once, the waiting caller included.
+        int GetConcurrency();
+
+        void Submit(TaskGroup& group, std::function<void()> task);
+        void Wait(TaskGroup& group);
+
+        // Calls body(rangeBegin, rangeEnd) on disjoint sub-ranges of at most grainSize indices covering
+        // [begin, end) and returns when all of them have finished. Ranges are split in halves on demand,
+        // so idle workers steal the largest remaining pieces. grainSize 0 picks about four ranges per thread.
+        void ParallelFor(int64_t begin, int64_t end, int64_t grainSize, std::function<void(int64_t, int64_t)> const& body);
+
+        // Pool used by the library stages. Replacing it is only safe while no stage is running;
+        // nullptr restores the built-in pool.
+        static ThreadPool& GetDefault();
+        static void SetDefault(ThreadPool* pool);
+
+    private:
+        struct Task
+        {
+            std::function<void()> Function;
+            TaskGroup* Group;
+        };
+
+        struct WorkerQueue
+        {
+            std::mutex Mutex;
+            std::deque<Task> Tasks;
+        };
+
+        std::vector<std::thread> _workers;
+        std::unique_ptr<WorkerQueue[]> _queues;
+        int _workerCount;
+
+        std::atomic<int> _queuedTaskCount;
+        std::atomic<int> _sleepingCount;
+        std::atomic<uint32_t> _nextQueue;
+        std::atomic<bool> _stopping;
+        std::mutex _sleepMutex;
+        std::condition_variable _wakeCondition;
+
+        void WorkerMain(int index);
+        int GetCurrentWorkerIndex();
+        bool TryPop(int index, Task& task);
+        bool TrySteal(int thief, Task& task);
+        void Execute(Task& task);
+        void SplitRange(int64_t begin, int64_t end, int64_t grainSize,
+                        std::function<void(int64_t, int64_t)> const& body, TaskGroup& group);
+
+        static void PinCurrentThread(int cpu);
+    };
+}
@@ -0,0 +1,358 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#include "TiledNeighborQuery.h"
+#include "NeighborHeap.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+SignalScatter::TiledNeighborQuery::TiledNeighborQuery(uint32_t tileSize)
+{
+    _tileSize = (tileSize > 0) ? tileSize : 1;
+    _clusterCulling = false;
+}
+
+SignalScatter::TiledNeighborQuery::~TiledNeighborQuery()
+{
+}
+
+uint32_t SignalScatter::TiledNeighborQuery::GetTileSize()
+{
+    return _tileSize;
+}
+
+bool SignalScatter::TiledNeighborQuery::GetClusterCulling()
+{
+    return _clusterCulling;
+}
+
+void SignalScatter::TiledNeighborQuery::SetClusterCulling(bool enabled)
+{
+    _clusterCulling = enabled;
+}
+
+uint32_t const* SignalScatter::TiledNeighborQuery::GetNeighborOffsets()
+{
+    return _neighborOffsets.data();
+}
+
+float const* SignalScatter::TiledNeighborQuery::GetNeighborDistances()
+{
+    return _neighborDistances.data();
+}
+
+uint32_t const* SignalScatter::TiledNeighborQuery::GetNeighborIds()
+{
+    return _neighborIds.data();
+}
+
+void SignalScatter::TiledNeighborQuery::LoadPoints(Point const* listeners, uint32_t listenerCount,
+                                                   Point const* emitters, uint32_t emitterCount)
+{
+    _rowX.resize(listenerCount);
+    _rowY.resize(listenerCount);
+    _rowZ.resize(listenerCount);
+
+    for (uint32_t i = 0; i < listenerCount; i++)
+    {
+        _rowX[i] = listeners[i].PositionX;
+        _rowY[i] = listeners[i].PositionY;
+        _rowZ[i] = listeners[i].PositionZ;
+    }
+
+    _columnX.resize(emitterCount);
+    _columnY.resize(emitterCount);
+    _columnZ.resize(emitterCount);
+    _columnIds.resize(emitterCount);
+
+    for (uint32_t i = 0; i < emitterCount; i++)
+    {
+        _columnX[i] = emitters[i].PositionX;
+        _columnY[i] = emitters[i].PositionY;
+        _columnZ[i] = emitters[i].PositionZ;
+        _columnIds[i] = emitters[i].Id;
+    }
+
+    if (_clusterCulling)
+    {
+        BuildClusters(_rowX, _rowY, _rowZ, _rowClusters);
+        BuildClusters(_columnX, _columnY, _columnZ, _columnClusters);
+    }
+}
+
+void SignalScatter::TiledNeighborQuery::BuildClusters(std::vector<float> const& x, std::vector<float> const& y,
+                                                      std::vector<float> const& z, std::vector<BoundingBox>& clusters)
+{
+    uint32_t count = (uint32_t)x.size();
+    uint32_t clusterCount = (count + _tileSize - 1) / _tileSize;
+    clusters.assign(clusterCount, BoundingBox());
+
+    ThreadPool::GetDefault().ParallelFor(0, clusterCount, 0, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        for (int64_t cluster = rangeBegin; cluster < rangeEnd; cluster++)
+        {
+            uint32_t begin = (uint32_t)cluster * _tileSize;
+            uint32_t end = std::min(begin + _tileSize, count);
+            for (uint32_t i = begin; i < end; i++)
+            {
+                clusters[cluster].Add(x[i], y[i], z[i]);
+            }
+        }
+    });
+}
+
+// Squared distances of rows [rowBegin, rowEnd) against columns [columnBegin, columnEnd).
+// The block is row-major with a stride of _tileSize.
+void SignalScatter::TiledNeighborQuery::CalculateBlock(uint32_t rowBegin, uint32_t rowEnd,
+                                                       uint32_t columnBegin, uint32_t columnEnd, float* block)
+{
+    float const* x = _columnX.data() + columnBegin;
+    float const* y = _columnY.data() + columnBegin;
+    float const* z = _columnZ.data() + columnBegin;
+    uint32_t columnCount = columnEnd - columnBegin;
+
+    for (uint32_t row = rowBegin; row < rowEnd; row++)
+    {
+        float ax = _rowX[row];
+        float ay = _rowY[row];
+        float az = _rowZ[row];
+        float* distances = block + (size_t)(row - rowBegin) * _tileSize;
+
+        for (uint32_t column = 0; column < columnCount; column++)
+        {
+            float dx = ax - x[column];
+            float dy = ay - y[column];
+            float dz = az - z[column];
+            distances[column] = dx * dx + dy * dy + dz * dz; // Squared Distance
+        }
+    }
+}
+
+void SignalScatter::TiledNeighborQuery::QueryNearest(Point const* points, uint32_t count, uint32_t k,
+                                                     float* nearestDistanceMatrix, uint32_t* nearestIdMatrix)
+{
+    QueryNearest(points, count, points, count, k, nearestDistanceMatrix, nearestIdMatrix);
+}
+
+void SignalScatter::TiledNeighborQuery::QueryNearest(Point const* listeners, uint32_t listenerCount,
+                                                     Point const* emitters, uint32_t emitterCount, uint32_t k,
+                                                     float* nearestDistanceMatrix, uint32_t* nearestIdMatrix)
+{
+    if (k == 0) { return; }
+
+    LoadPoints(listeners, listenerCount, emitters, emitterCount);
+
+    uint32_t tileSize = _tileSize;
+    int64_t tileCount = (listenerCount + tileSize - 1) / tileSize;
+    int64_t columnTileCount = (emitterCount + tileSize - 1) / tileSize;
+
+    ThreadPool::GetDefault().ParallelFor(0, tileCount, 1, [&](int64_t rangeBegin, int64_t rangeEnd)
+    {
+        std::vector<std::pair<float, uint32_t>> columnTiles;
+        std::vector<float> block((size_t)tileSize * tileSize);
+        std::vector<float> heapDistances((size_t)tileSize * k);
+        std::vector<uint32_t> heapIds((size_t)tileSize * k);
+
+        std::vector<NeighborHeap> heaps;
+        for (uint32_t i = 0; i < tileSize; i++)
+        {
+            heaps.emplace_back(heapDistances.data() + (size_t)i * k, heapIds.data() + (size_t)i * k, (int)k);
+        }
+
+        for (int64_t rowTile = rangeBegin; rowTile < rangeEnd; rowTile++)
+        {
+            uint32_t rowBegin = (uint32_t)rowTile * tileSize;
+            uint32_t rowEnd = std::min(rowBegin + tileSize, listenerCount);
+
+            // With culling, column tiles are visited nearest first so that the heaps fill with close
+            // candidates early and the remaining tiles can be cut off as a whole.
+            columnTiles.clear();
+            for (int64_t columnTile = 0; columnTile < columnTileCount; columnTile++)
+            {
+                float lowerBound = _clusterCulling ? GetMinimumSquaredDistance(_rowClusters[rowTile], _columnClusters[columnTile]) : 0.0f;
+                columnTiles.push_back(std::make_pair(lowerBound, (uint32_t)columnTile));
+            }
+            if (_clusterCulling)
+            {
+                std::sort(columnTiles.begin(), columnTiles.end());
+            }
+
+            for (size_t i = 0; i < columnTiles.size(); i++)
+            {
+                if (_clusterCulling)
+                {
+                    float threshold = 0.0f;
+                    for (uint32_t row = rowBegin; row < rowEnd; row++)
+                    {
+                        threshold = std::max(threshold, heaps[row - rowBegin].GetThreshold());
+                    }
+
+                    // No row of this tile can accept anything from here on.
+                    if (columnTiles[i].first >= threshold) { break; }
+                }
+
+                uint32_t columnBegin = columnTiles[i].second * tileSize;
+                uint32_t columnEnd = std::min(columnBegin + tileSize, emitterCount);
+                CalculateBlock(rowBegin, rowEnd, columnBegin, columnEnd, block.data());
+
+                for (uint32_t row = rowBegin; row < rowEnd; row++)
+                {
+                    heaps[row - rowBegin].PushRange(block.data() + (size_t)(row - rowBegin) * tileSize,
+                                                    _columnIds.data() + columnBegin, columnEnd - columnBegin);
+                }
+            }
+
+            for (uint32_t row = rowBegin; row < rowEnd; row++)
+            {
+                heaps[row - rowBegin].Sort(nearestDistanceMatrix + (size_t)row * k, nearestIdMatrix + (size_t)row * k);
+            }
+        }
+    });
+}
+
+void SignalScatter::TiledNeighborQuery::QueryRadius(Point const* points, uint32_t count, float radius, bool sorted)
+{
+    QueryRadius(points, count, points, count, radius, sorted);
+}
+
+void SignalScatter::TiledNeighborQuery::QueryRadius(Point const* listeners, uint32_t listenerCount,
+                                                    Point const* emitters, uint32_t emitterCount, float radius, bool sorted)
+{
+    LoadPoints(listeners, listenerCount, emitters, emitterCount);
+
+    uint32_t tileSize = _tileSize;
+    int64_t tileCount = (listenerCount + tileSize - 1) / tileSize;
+    float squaredRadius = radius * radius;
+
+    _neighborOffsets.assign(listenerCount + 1, 0);
+
+    // Two passes over the tiles: the first counts the survivors of every row so that the second
+    // can write them straight into their final CSR position.
+    for (int pass = 0; pass < 2; pass++)
+    {
+        if (pass == 1)
+        {
+            for (uint32_t i = 0; i < listenerCount; i++)
+            {
+                _neighborOffsets[i + 1] += _neighborOffsets[i];
+            }
+            _neighborDistances.resize(_neighborOffsets[listenerCount]);
+            _neighborIds.resize(_neighborOffsets[listenerCount]);
+        }
+
+        ThreadPool::GetDefault().ParallelFor(0, tileCount, 1, [&](int64_t rangeBegin, int64_t rangeEnd)
+        {
+            std::vector<float> block((size_t)tileSize * tileSize);
+            std::vector<uint32_t> cursors(tileSize);
+            std::vector<std::pair<float, uint32_t>> pairs;
+
+            for (int64_t rowTile = rangeBegin; rowTile < rangeEnd; rowTile++)
+            {
+                uint32_t rowBegin = (uint32_t)rowTile * tileSize;
+                uint32_t rowEnd = std::min(rowBegin + tileSize, listenerCount);
+
+                for (uint32_t row = rowBegin; row < rowEnd; row++)
+                {
+                    cursors[row - rowBegin] = (pass == 0) ? 0 : _neighborOffsets[row];
+                }
+
+                for (uint32_t columnBegin = 0; columnBegin < emitterCount; columnBegin += tileSize)
+                {
+                    uint32_t columnEnd = std::min(columnBegin + tileSize, emitterCount);
+                    uint32_t columnCount = columnEnd - columnBegin;
+
+                    // Clusters entirely out of range are skipped; clusters entirely in range are
+                    // accepted without per-point tests.
+                    bool acceptAll = false;
+                    if (_clusterCulling)
+                    {
+                        BoundingBox const& rowCluster = _rowClusters[rowTile];
+                        BoundingBox const& columnCluster = _columnClusters[columnBegin / tileSize];
+                        if (GetMinimumSquaredDistance(rowCluster, columnCluster) > squaredRadius) { continue; }
+                        acceptAll = (GetMaximumSquaredDistance(rowCluster, columnCluster) <= squaredRadius);
+                    }
+
+                    if (pass == 0 && acceptAll)
+                    {
+                        for (uint32_t row = rowBegin; row < rowEnd; row++)
+                        {
+                            cursors[row - rowBegin] += columnCount;
+                        }
+                        continue;
+                    }
+
+                    CalculateBlock(rowBegin, rowEnd, columnBegin, columnEnd, block.data());
+
+                    if (acceptAll)
+                    {
+                        for (uint32_t row = rowBegin; row < rowEnd; row++)
+                        {
+                            uint32_t& cursor = cursors[row - rowBegin];
+                            std::copy(block.data() + (size_t)(row - rowBegin) * tileSize,
+                                      block.data() + (size_t)(row - rowBegin) * tileSize + columnCount,
+                                      _neighborDistances.data() + cursor);
+                            std::copy(_columnIds.data() + columnBegin, _columnIds.data() + columnEnd,
+                                      _neighborIds.data() + cursor);
+                            cursor += columnCount;
+                        }
+                        continue;
+                    }
+
+                    for (uint32_t row = rowBegin; row < rowEnd; row++)
+                    {
+                        float const* distances = block.data() + (size_t)(row - rowBegin) * tileSize;
+                        uint32_t& cursor = cursors[row - rowBegin];
+
+                        if (pass == 0)
+                        {
+                            uint32_t found = 0;
+                            for (uint32_t column = 0; column < columnCount; column++)
+                            {
+                                found += (distances[column] <= squaredRadius);
+                            }
+                            cursor += found;
+                        }
+                        else
+                        {
+                            for (uint32_t column = 0; column < columnCount; column++)
+                            {
+                                if (distances[column] <= squaredRadius)
+                                {
+                                    _neighborDistances[cursor] = distances[column];
+                                    _neighborIds[cursor] = _columnIds[columnBegin + column];
+                                    cursor++;
+                                }
+                            }
+                        }
+                    }
+                }
+
+                for (uint32_t row = rowBegin; row < rowEnd; row++)
+                {
+                    if (pass == 0)
+                    {
+                        _neighborOffsets[row + 1] = cursors[row - rowBegin];
+                    }
+                    else if (sorted)
+                    {
+                        uint32_t begin = _neighborOffsets[row];
+                        uint32_t end = _neighborOffsets[row + 1];
+
+                        pairs.resize(end - begin);
+                        for (uint32_t i = begin; i < end; i++) { pairs[i - begin] = std::make_pair(_neighborDistances[i], _neighborIds[i]); }
+                        std::sort(pairs.begin(), pairs.end());
+                        for (uint32_t i = begin; i < end; i++)
+                        {
+                            _neighborDistances[i] = pairs[i - begin].first;
+                            _neighborIds[i] = pairs[i - begin].second;
+                        }
+                    }
+                }
+            }
+        });
+    }
+}
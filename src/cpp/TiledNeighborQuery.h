@@ -0,0 +1,75 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "BoundingBox.h"
+#include "Point.h"
+#include <cstdint>
+#include <vector>
+
+namespace SignalScatter
+{
+    // Fused distance-and-select pipeline. Distances are computed one tileSize x tileSize block at a time
+    // into a per-thread scratch block, reduced into each row's result right away and discarded, so the
+    // N x N matrix is never materialized. Peak memory is O(N * k + tileSize^2 per thread).
+    class TiledNeighborQuery
+    {
+    public:
+        TiledNeighborQuery(uint32_t tileSize = 64);
+        ~TiledNeighborQuery();
+
+        uint32_t GetTileSize();
+
+        // Treats every tile as a cluster with a bounding box and skips (or, for radius queries, bulk-accepts)
+        // whole tile pairs from cluster-to-cluster distance bounds. Effective when the points are in
+        // spatial order, e.g. after MortonOrder::Reorder.
+        bool GetClusterCulling();
+        void SetClusterCulling(bool enabled);
+
+        // k nearest points of every point, the point itself included. Output matrices are count x k,
+        // sorted ascending, with Point::Id values as IDs (same layout as SelectNearest).
+        void QueryNearest(Point const* points, uint32_t count, uint32_t k,
+                          float* nearestDistanceMatrix, uint32_t* nearestIdMatrix);
+
+        // Every point within the radius of every point, the point itself included, in CSR layout
+        // indexed by the position of the query point. When sorted is true each row is ordered by distance.
+        void QueryRadius(Point const* points, uint32_t count, float radius, bool sorted);
+
+        // Bipartite variants: rows are listeners, candidates are emitters, and the output has one row
+        // per listener. IDs are the emitters' Point::Id values.
+        void QueryNearest(Point const* listeners, uint32_t listenerCount, Point const* emitters, uint32_t emitterCount,
+                          uint32_t k, float* nearestDistanceMatrix, uint32_t* nearestIdMatrix);
+        void QueryRadius(Point const* listeners, uint32_t listenerCount, Point const* emitters, uint32_t emitterCount,
+                         float radius, bool sorted);
+
+        uint32_t const* GetNeighborOffsets();
+        float const* GetNeighborDistances();
+        uint32_t const* GetNeighborIds();
+
+    private:
+        uint32_t _tileSize;
+        bool _clusterCulling;
+
+        std::vector<float> _rowX;
+        std::vector<float> _rowY;
+        std::vector<float> _rowZ;
+
+        std::vector<float> _columnX;
+        std::vector<float> _columnY;
+        std::vector<float> _columnZ;
+        std::vector<uint32_t> _columnIds;
+
+        std::vector<BoundingBox> _rowClusters;
+        std::vector<BoundingBox> _columnClusters;
+
+        std::vector<uint32_t> _neighborOffsets;
+        std::vector<float> _neighborDistances;
+        std::vector<uint32_t> _neighborIds;
+
+        void LoadPoints(Point const* listeners, uint32_t listenerCount, Point const* emitters, uint32_t emitterCount);
+        void BuildClusters(std::vector<float> const& x, std::vector<float> const& y, std::vector<float> const& z,
+                           std::vector<BoundingBox>& clusters);
+        void CalculateBlock(uint32_t rowBegin, uint32_t rowEnd, uint32_t columnBegin, uint32_t columnEnd, float* block);
+    };
+}
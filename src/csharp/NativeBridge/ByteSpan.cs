@@ -0,0 +1,26 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+using System;
+using System.Runtime.InteropServices;
+
+namespace SignalScatter.NativeBridge
+{
+    /// <summary>
+    /// Mirror of the native SignalScatter::ByteSpan (pointer and length), used to pass spans across the C ABI.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public unsafe struct ByteSpan
+    {
+        public byte* Pointer;
+        public int Length;
+
+        public ByteSpan(byte* pointer, int length)
+        {
+            Pointer = pointer;
+            Length = length;
+        }
+
+        public ReadOnlySpan<byte> AsReadOnlySpan() => new ReadOnlySpan<byte>(Pointer, Length);
+    }
+}
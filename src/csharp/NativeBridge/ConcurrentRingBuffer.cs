@@ -0,0 +1,266 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+using System;
+using System.Runtime.InteropServices;
+
+namespace SignalScatter.NativeBridge
+{
+    public sealed unsafe class ConcurrentRingBuffer : IDisposable
+    {
+        public int BufferSize => NativeApi.ConcurrentRingBufferGetBufferSize(_handle);
+        public int Count => NativeApi.ConcurrentRingBufferGetCount(_handle);
+
+        public bool IsInvalid => _handle.IsInvalid;
+
+        private const int BatchSize = 64;
+
+        private readonly ConcurrentRingBufferHandle _handle;
+
+        internal ConcurrentRingBufferHandle Handle => _handle;
+
+        public ConcurrentRingBuffer(int capacity)
+        {
+            _handle = NativeApi.CreateConcurrentRingBuffer(capacity);
+        }
+
+        public void Dispose() => _handle.Dispose();
+
+        public bool TryBulkEnqueue(ReadOnlySpan<byte> span)
+        {
+            bool enqueued = false;
+
+            fixed (byte* pointer = span)
+            {
+                enqueued = NativeApi.ConcurrentRingBufferTryBulkEnqueue(_handle, pointer, span.Length);
+            }
+
+            return enqueued;
+        }
+
+        public bool TryBulkDequeue(Span<byte> span)
+        {
+            bool dequeued = false;
+
+            fixed (byte* pointer = span)
+            {
+                dequeued = NativeApi.ConcurrentRingBufferTryBulkDequeue(_handle, pointer, span.Length);
+            }
+
+            return dequeued;
+        }
+
+        public byte GetValue(int index) => NativeApi.ConcurrentRingBufferGetValue(_handle, index);
+        public byte GetHeadValue() => NativeApi.ConcurrentRingBufferGetHeadValue(_handle);
+
+        public void Clear() => NativeApi.ConcurrentRingBufferClear(_handle);
+        public void Clear(int length) => NativeApi.ConcurrentRingBufferClearLength(_handle, length);
+
+        /// <summary>
+        /// Raw view of ring storage; valid until the bytes are dequeued or cleared.
+        /// </summary>
+        public void Slice(int start, int length, out ByteSpan firstSegment, out ByteSpan secondSegment)
+        {
+            ByteSpan first;
+            ByteSpan second;
+            NativeApi.ConcurrentRingBufferSlice(_handle, start, length, &first, &second);
+            firstSegment = first;
+            secondSegment = second;
+        }
+
+        public bool TryBulkEnqueueByte4(ReadOnlySpan<byte> span)
+        {
+            if (span.Length != 4) { return false; }
+
+            fixed (byte* pointer = span)
+            {
+                return NativeApi.ConcurrentRingBufferTryBulkEnqueueByte4(_handle, pointer);
+            }
+        }
+
+        public bool TryBulkEnqueueByte8(ReadOnlySpan<byte> span)
+        {
+            if (span.Length != 8) { return false; }
+
+            fixed (byte* pointer = span)
+            {
+                return NativeApi.ConcurrentRingBufferTryBulkEnqueueByte8(_handle, pointer);
+            }
+        }
+
+        public bool TryBulkEnqueueByte16(ReadOnlySpan<byte> span)
+        {
+            if (span.Length != 16) { return false; }
+
+            fixed (byte* pointer = span)
+            {
+                return NativeApi.ConcurrentRingBufferTryBulkEnqueueByte16(_handle, pointer);
+            }
+        }
+
+        public bool TryBulkEnqueueByte32(ReadOnlySpan<byte> span)
+        {
+            if (span.Length != 32) { return false; }
+
+            fixed (byte* pointer = span)
+            {
+                return NativeApi.ConcurrentRingBufferTryBulkEnqueueByte32(_handle, pointer);
+            }
+        }
+
+        public bool TryBulkDequeueByte4(Span<byte> span)
+        {
+            if (span.Length != 4) { return false; }
+
+            fixed (byte* pointer = span)
+            {
+                return NativeApi.ConcurrentRingBufferTryBulkDequeueByte4(_handle, pointer);
+            }
+        }
+
+        public bool TryBulkDequeueByte8(Span<byte> span)
+        {
+            if (span.Length != 8) { return false; }
+
+            fixed (byte* pointer = span)
+            {
+                return NativeApi.ConcurrentRingBufferTryBulkDequeueByte8(_handle, pointer);
+            }
+        }
+
+        public bool TryBulkDequeueByte16(Span<byte> span)
+        {
+            if (span.Length != 16) { return false; }
+
+            fixed (byte* pointer = span)
+            {
+                return NativeApi.ConcurrentRingBufferTryBulkDequeueByte16(_handle, pointer);
+            }
+        }
+
+        public bool TryBulkDequeueByte32(Span<byte> span)
+        {
+            if (span.Length != 32) { return false; }
+
+            fixed (byte* pointer = span)
+            {
+                return NativeApi.ConcurrentRingBufferTryBulkDequeueByte32(_handle, pointer);
+            }
+        }
+
+        /// <summary>
+        /// Claims up to maxLength readable bytes, in whole records of recordSize bytes, for this consumer and
+        /// exposes them as spans over ring storage, without copying. Producers cannot reuse the bytes until ReleaseRead.
+        /// </summary>
+        public ReadSegments AcquireRead(int maxLength, int recordSize = 1)
+        {
+            ByteSpan first;
+            ByteSpan second;
+            int token;
+            NativeApi.ConcurrentRingBufferAcquireRead(_handle, maxLength, recordSize, &first, &second, &token);
+            return new ReadSegments(first, second, token);
+        }
+
+        public void ReleaseRead(in ReadSegments segments) => NativeApi.ConcurrentRingBufferReleaseRead(_handle, segments.Token, segments.Length);
+
+        /// <summary>
+        /// Claims exactly length free bytes for this producer and exposes them as writable spans.
+        /// The whole reservation becomes readable with CommitWrite.
+        /// </summary>
+        public bool TryReserveWrite(int length, out WriteSegments segments)
+        {
+            ByteSpan first;
+            ByteSpan second;
+            int token;
+            bool reserved = NativeApi.ConcurrentRingBufferReserveWrite(_handle, length, &first, &second, &token);
+            segments = reserved ? new WriteSegments(first, second, token) : default;
+            return reserved;
+        }
+
+        public void CommitWrite(in WriteSegments segments) => NativeApi.ConcurrentRingBufferCommitWrite(_handle, segments.Token, segments.Length);
+
+        /// <summary>
+        /// Enqueues consecutive records of the given lengths from buffer, one native call per BatchSize records.
+        /// Stops at the first record that does not fit and returns the number of records enqueued.
+        /// </summary>
+        public int EnqueueBatch(ReadOnlySpan<byte> buffer, ReadOnlySpan<int> lengths)
+        {
+            ByteSpan* spans = stackalloc ByteSpan[BatchSize];
+            int enqueuedCount = 0;
+
+            fixed (byte* pointer = buffer)
+            {
+                int offset = 0;
+                while (enqueuedCount < lengths.Length)
+                {
+                    int spanCount = Math.Min(BatchSize, lengths.Length - enqueuedCount);
+                    for (int i = 0; i < spanCount; i++)
+                    {
+                        int length = lengths[enqueuedCount + i];
+                        if (length < 0 || offset + length > buffer.Length) { throw new ArgumentOutOfRangeException(nameof(lengths)); }
+
+                        spans[i] = new ByteSpan(pointer + offset, length);
+                        offset += length;
+                    }
+
+                    int batchCount = NativeApi.ConcurrentRingBufferEnqueueBatch(_handle, spans, spanCount);
+                    enqueuedCount += batchCount;
+                    if (batchCount < spanCount) { break; }
+                }
+            }
+
+            return enqueuedCount;
+        }
+
+        /// <summary>
+        /// Dequeues as many whole records of recordSize bytes as fit into destination. Returns the record count.
+        /// </summary>
+        public int DequeueBatch(Span<byte> destination, int recordSize)
+        {
+            if (recordSize <= 0) { return 0; }
+
+            fixed (byte* pointer = destination)
+            {
+                return NativeApi.ConcurrentRingBufferDequeueBatch(_handle, pointer, recordSize, destination.Length / recordSize);
+            }
+        }
+
+        public int EnqueueFromFd(int fd, int maxBytes) => NativeApi.ConcurrentRingBufferEnqueueFromFd(_handle, fd, maxBytes);
+        public int DequeueToFd(int fd, int maxBytes) => NativeApi.ConcurrentRingBufferDequeueToFd(_handle, fd, maxBytes);
+
+        /// <summary>
+        /// Returns an eventfd that becomes readable when data arrives after ArmReadableEvent (-1 if unsupported).
+        /// The descriptor is owned by the ring.
+        /// </summary>
+        public int EnableReadableEvent() => NativeApi.ConcurrentRingBufferEnableReadableEvent(_handle);
+
+        /// <summary>
+        /// Returns an eventfd that becomes readable when the count drops to lowWatermark after ArmWritableEvent (-1 if unsupported).
+        /// </summary>
+        public int EnableWritableEvent(int lowWatermark) => NativeApi.ConcurrentRingBufferEnableWritableEvent(_handle, lowWatermark);
+
+        public bool ArmReadableEvent() => NativeApi.ConcurrentRingBufferArmReadableEvent(_handle);
+        public bool ArmWritableEvent() => NativeApi.ConcurrentRingBufferArmWritableEvent(_handle);
+
+        public bool WaitReadable(int timeoutMilliseconds) => NativeApi.ConcurrentRingBufferWaitReadable(_handle, timeoutMilliseconds);
+        public bool WaitWritable(int timeoutMilliseconds) => NativeApi.ConcurrentRingBufferWaitWritable(_handle, timeoutMilliseconds);
+    }
+
+    internal sealed class ConcurrentRingBufferHandle : SafeHandle
+    {
+        public override bool IsInvalid => IntPtr.Zero == handle;
+
+        private ConcurrentRingBufferHandle() : base(invalidHandleValue: IntPtr.Zero, ownsHandle: true)
+        {
+        }
+
+        protected override bool ReleaseHandle()
+        {
+            NativeApi.ReleaseConcurrentRingBuffer(handle);
+#if DEVELOPMENT_BUILD
+            Console.WriteLine($"ConcurrentRingBufferHandle.ReleaseHandle");
+#endif
+            return true;
+        }
+    }
+}
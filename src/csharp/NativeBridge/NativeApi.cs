@@ -26,9 +26,280 @@ namespace SignalScatter.NativeBridge
         public static extern int RingBufferGetCount(RingBufferHandle handle);
 
         [DllImport(DLL_NAME, EntryPoint = "ring_buffer_try_bulk_enqueue", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
         public static extern bool RingBufferTryBulkEnqueue(RingBufferHandle handle, byte* pointer, int length);
 
         [DllImport(DLL_NAME, EntryPoint = "ring_buffer_try_bulk_dequeue", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
         public static extern bool RingBufferTryBulkDequeue(RingBufferHandle handle, byte* pointer, int length);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_clear", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void RingBufferClear(RingBufferHandle handle);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_clear_length", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void RingBufferClearLength(RingBufferHandle handle, int length);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_slice", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void RingBufferSlice(RingBufferHandle handle, int start, int length, ByteSpan* firstSegment, ByteSpan* secondSegment);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_try_bulk_enqueue_byte4", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool RingBufferTryBulkEnqueueByte4(RingBufferHandle handle, byte* pointer);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_try_bulk_enqueue_byte8", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool RingBufferTryBulkEnqueueByte8(RingBufferHandle handle, byte* pointer);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_try_bulk_enqueue_byte16", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool RingBufferTryBulkEnqueueByte16(RingBufferHandle handle, byte* pointer);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_try_bulk_enqueue_byte32", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool RingBufferTryBulkEnqueueByte32(RingBufferHandle handle, byte* pointer);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_try_bulk_dequeue_byte4", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool RingBufferTryBulkDequeueByte4(RingBufferHandle handle, byte* pointer);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_try_bulk_dequeue_byte8", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool RingBufferTryBulkDequeueByte8(RingBufferHandle handle, byte* pointer);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_try_bulk_dequeue_byte16", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool RingBufferTryBulkDequeueByte16(RingBufferHandle handle, byte* pointer);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_try_bulk_dequeue_byte32", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool RingBufferTryBulkDequeueByte32(RingBufferHandle handle, byte* pointer);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_acquire_read", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int RingBufferAcquireRead(RingBufferHandle handle, int maxLength, ByteSpan* firstSegment, ByteSpan* secondSegment, int* token);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_release_read", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void RingBufferReleaseRead(RingBufferHandle handle, int token, int length);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_reserve_write", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool RingBufferReserveWrite(RingBufferHandle handle, int length, ByteSpan* firstSegment, ByteSpan* secondSegment);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_commit_write", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void RingBufferCommitWrite(RingBufferHandle handle, int length);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_enqueue_batch", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int RingBufferEnqueueBatch(RingBufferHandle handle, ByteSpan* spans, int spanCount);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_dequeue_batch", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int RingBufferDequeueBatch(RingBufferHandle handle, byte* destination, int recordSize, int maxRecordCount);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_enqueue_from_fd", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int RingBufferEnqueueFromFd(RingBufferHandle handle, int fd, int maxBytes);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_buffer_dequeue_to_fd", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int RingBufferDequeueToFd(RingBufferHandle handle, int fd, int maxBytes);
+
+        //////////////////////////////
+        ///  ConcurrentRingBuffer  ///
+        //////////////////////////////
+        [DllImport(DLL_NAME, EntryPoint = "create_concurrent_ring_buffer", CallingConvention = CallingConvention.Cdecl)]
+        public static extern ConcurrentRingBufferHandle CreateConcurrentRingBuffer(int capacity);
+
+        [DllImport(DLL_NAME, EntryPoint = "release_concurrent_ring_buffer", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void ReleaseConcurrentRingBuffer(IntPtr handle);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_get_buffer_size", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ConcurrentRingBufferGetBufferSize(ConcurrentRingBufferHandle handle);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_get_count", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ConcurrentRingBufferGetCount(ConcurrentRingBufferHandle handle);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_try_bulk_enqueue", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ConcurrentRingBufferTryBulkEnqueue(ConcurrentRingBufferHandle handle, byte* pointer, int length);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_try_bulk_dequeue", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ConcurrentRingBufferTryBulkDequeue(ConcurrentRingBufferHandle handle, byte* pointer, int length);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_get_value", CallingConvention = CallingConvention.Cdecl)]
+        public static extern byte ConcurrentRingBufferGetValue(ConcurrentRingBufferHandle handle, int index);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_get_head_value", CallingConvention = CallingConvention.Cdecl)]
+        public static extern byte ConcurrentRingBufferGetHeadValue(ConcurrentRingBufferHandle handle);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_clear", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void ConcurrentRingBufferClear(ConcurrentRingBufferHandle handle);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_clear_length", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void ConcurrentRingBufferClearLength(ConcurrentRingBufferHandle handle, int length);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_slice", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void ConcurrentRingBufferSlice(ConcurrentRingBufferHandle handle, int start, int length, ByteSpan* firstSegment, ByteSpan* secondSegment);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_try_bulk_enqueue_byte4", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ConcurrentRingBufferTryBulkEnqueueByte4(ConcurrentRingBufferHandle handle, byte* pointer);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_try_bulk_enqueue_byte8", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ConcurrentRingBufferTryBulkEnqueueByte8(ConcurrentRingBufferHandle handle, byte* pointer);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_try_bulk_enqueue_byte16", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ConcurrentRingBufferTryBulkEnqueueByte16(ConcurrentRingBufferHandle handle, byte* pointer);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_try_bulk_enqueue_byte32", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ConcurrentRingBufferTryBulkEnqueueByte32(ConcurrentRingBufferHandle handle, byte* pointer);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_try_bulk_dequeue_byte4", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ConcurrentRingBufferTryBulkDequeueByte4(ConcurrentRingBufferHandle handle, byte* pointer);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_try_bulk_dequeue_byte8", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ConcurrentRingBufferTryBulkDequeueByte8(ConcurrentRingBufferHandle handle, byte* pointer);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_try_bulk_dequeue_byte16", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ConcurrentRingBufferTryBulkDequeueByte16(ConcurrentRingBufferHandle handle, byte* pointer);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_try_bulk_dequeue_byte32", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ConcurrentRingBufferTryBulkDequeueByte32(ConcurrentRingBufferHandle handle, byte* pointer);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_acquire_read", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ConcurrentRingBufferAcquireRead(ConcurrentRingBufferHandle handle, int maxLength, int recordSize, ByteSpan* firstSegment, ByteSpan* secondSegment, int* token);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_release_read", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void ConcurrentRingBufferReleaseRead(ConcurrentRingBufferHandle handle, int token, int length);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_reserve_write", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ConcurrentRingBufferReserveWrite(ConcurrentRingBufferHandle handle, int length, ByteSpan* firstSegment, ByteSpan* secondSegment, int* token);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_commit_write", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void ConcurrentRingBufferCommitWrite(ConcurrentRingBufferHandle handle, int token, int length);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_enqueue_batch", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ConcurrentRingBufferEnqueueBatch(ConcurrentRingBufferHandle handle, ByteSpan* spans, int spanCount);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_dequeue_batch", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ConcurrentRingBufferDequeueBatch(ConcurrentRingBufferHandle handle, byte* destination, int recordSize, int maxRecordCount);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_enqueue_from_fd", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ConcurrentRingBufferEnqueueFromFd(ConcurrentRingBufferHandle handle, int fd, int maxBytes);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_dequeue_to_fd", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ConcurrentRingBufferDequeueToFd(ConcurrentRingBufferHandle handle, int fd, int maxBytes);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_enable_readable_event", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ConcurrentRingBufferEnableReadableEvent(ConcurrentRingBufferHandle handle);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_enable_writable_event", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ConcurrentRingBufferEnableWritableEvent(ConcurrentRingBufferHandle handle, int lowWatermark);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_arm_readable_event", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ConcurrentRingBufferArmReadableEvent(ConcurrentRingBufferHandle handle);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_arm_writable_event", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ConcurrentRingBufferArmWritableEvent(ConcurrentRingBufferHandle handle);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_wait_readable", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ConcurrentRingBufferWaitReadable(ConcurrentRingBufferHandle handle, int timeoutMilliseconds);
+
+        [DllImport(DLL_NAME, EntryPoint = "concurrent_ring_buffer_wait_writable", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ConcurrentRingBufferWaitWritable(ConcurrentRingBufferHandle handle, int timeoutMilliseconds);
+
+        ///////////////////
+        ///  RingGroup  ///
+        ///////////////////
+        [DllImport(DLL_NAME, EntryPoint = "create_ring_group", CallingConvention = CallingConvention.Cdecl)]
+        public static extern RingGroupHandle CreateRingGroup(int capacity);
+
+        [DllImport(DLL_NAME, EntryPoint = "release_ring_group", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void ReleaseRingGroup(IntPtr handle);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_group_get_member_count", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int RingGroupGetMemberCount(RingGroupHandle handle);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_group_add", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int RingGroupAdd(RingGroupHandle handle, ConcurrentRingBufferHandle ringBuffer);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_group_remove", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void RingGroupRemove(RingGroupHandle handle, int member);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_group_poll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int RingGroupPoll(RingGroupHandle handle, int* members, int maxCount);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_group_drain", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int RingGroupDrain(RingGroupHandle handle, int budgetPerRing, int recordSize, byte* buffer, int bufferSize,
+                                                int* members, int* lengths, int maxEntryCount);
+
+        //////////////////
+        ///  RingPool  ///
+        //////////////////
+        [DllImport(DLL_NAME, EntryPoint = "create_ring_pool", CallingConvention = CallingConvention.Cdecl)]
+        public static extern RingPoolHandle CreateRingPool(int maxRingCount);
+
+        [DllImport(DLL_NAME, EntryPoint = "release_ring_pool", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void ReleaseRingPool(IntPtr handle);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_pool_preallocate", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int RingPoolPreallocate(RingPoolHandle handle, int capacity, int count, [MarshalAs(UnmanagedType.U1)] bool concurrent);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_pool_acquire", CallingConvention = CallingConvention.Cdecl)]
+        public static extern long RingPoolAcquire(RingPoolHandle handle, int capacity);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_pool_acquire_concurrent", CallingConvention = CallingConvention.Cdecl)]
+        public static extern long RingPoolAcquireConcurrent(RingPoolHandle handle, int capacity);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_pool_release", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void RingPoolRelease(RingPoolHandle handle, long ring);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_pool_get_count", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int RingPoolGetCount(RingPoolHandle handle, long ring);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_pool_try_bulk_enqueue", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool RingPoolTryBulkEnqueue(RingPoolHandle handle, long ring, byte* pointer, int length);
+
+        [DllImport(DLL_NAME, EntryPoint = "ring_pool_try_bulk_dequeue", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool RingPoolTryBulkDequeue(RingPoolHandle handle, long ring, byte* pointer, int length);
+
+        ///////////////////////
+        ///  ScatterEngine  ///
+        ///////////////////////
+        [DllImport(DLL_NAME, EntryPoint = "create_scatter_engine", CallingConvention = CallingConvention.Cdecl)]
+        public static extern ScatterEngineHandle CreateScatterEngine(uint pointCount, int inboxCapacity, uint arenaSize, uint maxMessageCount);
+
+        [DllImport(DLL_NAME, EntryPoint = "release_scatter_engine", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void ReleaseScatterEngine(IntPtr handle);
+
+        [DllImport(DLL_NAME, EntryPoint = "scatter_engine_publish", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ScatterEnginePublish(ScatterEngineHandle handle, uint source, byte* pointer, int length);
+
+        [DllImport(DLL_NAME, EntryPoint = "scatter_engine_scatter", CallingConvention = CallingConvention.Cdecl)]
+        public static extern uint ScatterEngineScatter(ScatterEngineHandle handle, uint k, uint* neighborIdMatrix);
+
+        [DllImport(DLL_NAME, EntryPoint = "scatter_engine_scatter_csr", CallingConvention = CallingConvention.Cdecl)]
+        public static extern uint ScatterEngineScatterCsr(ScatterEngineHandle handle, uint* neighborOffsets, uint* neighborIds);
+
+        [DllImport(DLL_NAME, EntryPoint = "scatter_engine_get_dropped_count", CallingConvention = CallingConvention.Cdecl)]
+        public static extern uint ScatterEngineGetDroppedCount(ScatterEngineHandle handle);
+
+        [DllImport(DLL_NAME, EntryPoint = "scatter_engine_try_receive", CallingConvention = CallingConvention.Cdecl)]
+        [return: MarshalAs(UnmanagedType.U1)]
+        public static extern bool ScatterEngineTryReceive(ScatterEngineHandle handle, uint point, byte** pointer, int* length);
+
+        [DllImport(DLL_NAME, EntryPoint = "scatter_engine_reset_frame", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void ScatterEngineResetFrame(ScatterEngineHandle handle);
     }
 }
\ No newline at end of file
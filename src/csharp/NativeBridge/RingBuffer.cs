@@ -13,6 +13,8 @@ namespace SignalScatter.NativeBridge
 
         public bool IsInvalid => _handle.IsInvalid;
 
+        private const int BatchSize = 64;
+
         private readonly RingBufferHandle _handle;
 
         public RingBuffer(int capacity)
@@ -45,6 +47,187 @@ namespace SignalScatter.NativeBridge
 
             return dequeued;
         }
+
+        public void Clear() => NativeApi.RingBufferClear(_handle);
+        public void Clear(int length) => NativeApi.RingBufferClearLength(_handle, length);
+
+        /// <summary>
+        /// Raw view of ring storage; valid until the bytes are dequeued or cleared.
+        /// </summary>
+        public void Slice(int start, int length, out ByteSpan firstSegment, out ByteSpan secondSegment)
+        {
+            ByteSpan first;
+            ByteSpan second;
+            NativeApi.RingBufferSlice(_handle, start, length, &first, &second);
+            firstSegment = first;
+            secondSegment = second;
+        }
+
+        public bool TryBulkEnqueueByte4(ReadOnlySpan<byte> span)
+        {
+            if (span.Length != 4) { return false; }
+
+            fixed (byte* pointer = span)
+            {
+                return NativeApi.RingBufferTryBulkEnqueueByte4(_handle, pointer);
+            }
+        }
+
+        public bool TryBulkEnqueueByte8(ReadOnlySpan<byte> span)
+        {
+            if (span.Length != 8) { return false; }
+
+            fixed (byte* pointer = span)
+            {
+                return NativeApi.RingBufferTryBulkEnqueueByte8(_handle, pointer);
+            }
+        }
+
+        public bool TryBulkEnqueueByte16(ReadOnlySpan<byte> span)
+        {
+            if (span.Length != 16) { return false; }
+
+            fixed (byte* pointer = span)
+            {
+                return NativeApi.RingBufferTryBulkEnqueueByte16(_handle, pointer);
+            }
+        }
+
+        public bool TryBulkEnqueueByte32(ReadOnlySpan<byte> span)
+        {
+            if (span.Length != 32) { return false; }
+
+            fixed (byte* pointer = span)
+            {
+                return NativeApi.RingBufferTryBulkEnqueueByte32(_handle, pointer);
+            }
+        }
+
+        public bool TryBulkDequeueByte4(Span<byte> span)
+        {
+            if (span.Length != 4) { return false; }
+
+            fixed (byte* pointer = span)
+            {
+                return NativeApi.RingBufferTryBulkDequeueByte4(_handle, pointer);
+            }
+        }
+
+        public bool TryBulkDequeueByte8(Span<byte> span)
+        {
+            if (span.Length != 8) { return false; }
+
+            fixed (byte* pointer = span)
+            {
+                return NativeApi.RingBufferTryBulkDequeueByte8(_handle, pointer);
+            }
+        }
+
+        public bool TryBulkDequeueByte16(Span<byte> span)
+        {
+            if (span.Length != 16) { return false; }
+
+            fixed (byte* pointer = span)
+            {
+                return NativeApi.RingBufferTryBulkDequeueByte16(_handle, pointer);
+            }
+        }
+
+        public bool TryBulkDequeueByte32(Span<byte> span)
+        {
+            if (span.Length != 32) { return false; }
+
+            fixed (byte* pointer = span)
+            {
+                return NativeApi.RingBufferTryBulkDequeueByte32(_handle, pointer);
+            }
+        }
+
+        /// <summary>
+        /// Exposes up to maxLength readable bytes as spans over ring storage, without copying.
+        /// The spans stay valid until ReleaseRead.
+        /// </summary>
+        public ReadSegments AcquireRead(int maxLength)
+        {
+            ByteSpan first;
+            ByteSpan second;
+            int token;
+            NativeApi.RingBufferAcquireRead(_handle, maxLength, &first, &second, &token);
+            return new ReadSegments(first, second, token);
+        }
+
+        public void ReleaseRead(in ReadSegments segments) => ReleaseRead(segments, segments.Length);
+
+        /// <summary>
+        /// Consumes the first length bytes of the acquired segments; the rest stays readable.
+        /// </summary>
+        public void ReleaseRead(in ReadSegments segments, int length) => NativeApi.RingBufferReleaseRead(_handle, segments.Token, length);
+
+        /// <summary>
+        /// Exposes length free bytes as writable spans over ring storage. Nothing is readable until CommitWrite.
+        /// </summary>
+        public bool TryReserveWrite(int length, out WriteSegments segments)
+        {
+            ByteSpan first;
+            ByteSpan second;
+            bool reserved = NativeApi.RingBufferReserveWrite(_handle, length, &first, &second);
+            segments = reserved ? new WriteSegments(first, second, 0) : default;
+            return reserved;
+        }
+
+        /// <summary>
+        /// Publishes the first length bytes of the last reservation.
+        /// </summary>
+        public void CommitWrite(int length) => NativeApi.RingBufferCommitWrite(_handle, length);
+
+        /// <summary>
+        /// Enqueues consecutive records of the given lengths from buffer, one native call per BatchSize records.
+        /// Stops at the first record that does not fit and returns the number of records enqueued.
+        /// </summary>
+        public int EnqueueBatch(ReadOnlySpan<byte> buffer, ReadOnlySpan<int> lengths)
+        {
+            ByteSpan* spans = stackalloc ByteSpan[BatchSize];
+            int enqueuedCount = 0;
+
+            fixed (byte* pointer = buffer)
+            {
+                int offset = 0;
+                while (enqueuedCount < lengths.Length)
+                {
+                    int spanCount = Math.Min(BatchSize, lengths.Length - enqueuedCount);
+                    for (int i = 0; i < spanCount; i++)
+                    {
+                        int length = lengths[enqueuedCount + i];
+                        if (length < 0 || offset + length > buffer.Length) { throw new ArgumentOutOfRangeException(nameof(lengths)); }
+
+                        spans[i] = new ByteSpan(pointer + offset, length);
+                        offset += length;
+                    }
+
+                    int batchCount = NativeApi.RingBufferEnqueueBatch(_handle, spans, spanCount);
+                    enqueuedCount += batchCount;
+                    if (batchCount < spanCount) { break; }
+                }
+            }
+
+            return enqueuedCount;
+        }
+
+        /// <summary>
+        /// Dequeues as many whole records of recordSize bytes as fit into destination. Returns the record count.
+        /// </summary>
+        public int DequeueBatch(Span<byte> destination, int recordSize)
+        {
+            if (recordSize <= 0) { return 0; }
+
+            fixed (byte* pointer = destination)
+            {
+                return NativeApi.RingBufferDequeueBatch(_handle, pointer, recordSize, destination.Length / recordSize);
+            }
+        }
+
+        public int EnqueueFromFd(int fd, int maxBytes) => NativeApi.RingBufferEnqueueFromFd(_handle, fd, maxBytes);
+        public int DequeueToFd(int fd, int maxBytes) => NativeApi.RingBufferDequeueToFd(_handle, fd, maxBytes);
     }
 
     internal sealed class RingBufferHandle : SafeHandle
@@ -0,0 +1,99 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+using System;
+using System.Runtime.InteropServices;
+
+namespace SignalScatter.NativeBridge
+{
+    /// <summary>
+    /// Tracks which member rings hold data so one call per tick finds or drains only the active ones.
+    /// Poll and Drain must be called from a single consumer thread.
+    /// </summary>
+    public sealed unsafe class RingGroup : IDisposable
+    {
+        public int Capacity => _members.Length;
+        public int MemberCount => NativeApi.RingGroupGetMemberCount(_handle);
+
+        public bool IsInvalid => _handle.IsInvalid;
+
+        private readonly RingGroupHandle _handle;
+
+        // Keeps member rings alive while the native group references them.
+        private readonly ConcurrentRingBuffer[] _members;
+
+        public RingGroup(int capacity)
+        {
+            _handle = NativeApi.CreateRingGroup(capacity);
+            _members = new ConcurrentRingBuffer[capacity];
+        }
+
+        public void Dispose() => _handle.Dispose();
+
+        /// <summary>
+        /// Returns the member index of the ring, or -1 if the group is full.
+        /// </summary>
+        public int Add(ConcurrentRingBuffer ring)
+        {
+            int member = NativeApi.RingGroupAdd(_handle, ring.Handle);
+            if (member >= 0) { _members[member] = ring; }
+            return member;
+        }
+
+        public void Remove(int member)
+        {
+            NativeApi.RingGroupRemove(_handle, member);
+            if (member >= 0 && member < _members.Length) { _members[member] = null; }
+        }
+
+        public ConcurrentRingBuffer GetMember(int member) => _members[member];
+
+        /// <summary>
+        /// Fills members with indices of non-empty rings. Returns the number written.
+        /// </summary>
+        public int Poll(Span<int> members)
+        {
+            fixed (int* pointer = members)
+            {
+                return NativeApi.RingGroupPoll(_handle, pointer, members.Length);
+            }
+        }
+
+        /// <summary>
+        /// Dequeues up to budgetPerRing bytes, in whole records of recordSize bytes, from each non-empty ring
+        /// into buffer, back to back. Entry i holds lengths[i] bytes from ring members[i]. Returns the entry count.
+        /// Rings are drained in parallel, each into its own budgetPerRing slot of buffer, so at most
+        /// buffer.Length / budgetPerRing rings are drained per call.
+        /// </summary>
+        public int Drain(int budgetPerRing, int recordSize, Span<byte> buffer, Span<int> members, Span<int> lengths)
+        {
+            int maxEntryCount = Math.Min(members.Length, lengths.Length);
+
+            fixed (byte* bufferPointer = buffer)
+            fixed (int* membersPointer = members)
+            fixed (int* lengthsPointer = lengths)
+            {
+                return NativeApi.RingGroupDrain(_handle, budgetPerRing, recordSize, bufferPointer, buffer.Length,
+                                                membersPointer, lengthsPointer, maxEntryCount);
+            }
+        }
+    }
+
+    internal sealed class RingGroupHandle : SafeHandle
+    {
+        public override bool IsInvalid => IntPtr.Zero == handle;
+
+        private RingGroupHandle() : base(invalidHandleValue: IntPtr.Zero, ownsHandle: true)
+        {
+        }
+
+        protected override bool ReleaseHandle()
+        {
+            NativeApi.ReleaseRingGroup(handle);
+#if DEVELOPMENT_BUILD
+            Console.WriteLine($"RingGroupHandle.ReleaseHandle");
+#endif
+            return true;
+        }
+    }
+}
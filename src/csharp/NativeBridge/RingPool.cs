@@ -0,0 +1,70 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+using System;
+using System.Runtime.InteropServices;
+
+namespace SignalScatter.NativeBridge
+{
+    /// <summary>
+    /// Recycled ring buffers addressed by generation-checked handles. Released handles stop working
+    /// even if their ring is handed out again.
+    /// </summary>
+    public sealed unsafe class RingPool : IDisposable
+    {
+        public const long InvalidHandle = -1;
+
+        public bool IsInvalid => _handle.IsInvalid;
+
+        private readonly RingPoolHandle _handle;
+
+        public RingPool(int maxRingCount)
+        {
+            _handle = NativeApi.CreateRingPool(maxRingCount);
+        }
+
+        public void Dispose() => _handle.Dispose();
+
+        public int Preallocate(int capacity, int count, bool concurrent) => NativeApi.RingPoolPreallocate(_handle, capacity, count, concurrent);
+
+        public long Acquire(int capacity) => NativeApi.RingPoolAcquire(_handle, capacity);
+        public long AcquireConcurrent(int capacity) => NativeApi.RingPoolAcquireConcurrent(_handle, capacity);
+        public void Release(long ring) => NativeApi.RingPoolRelease(_handle, ring);
+
+        public int GetCount(long ring) => NativeApi.RingPoolGetCount(_handle, ring);
+
+        public bool TryBulkEnqueue(long ring, ReadOnlySpan<byte> span)
+        {
+            fixed (byte* pointer = span)
+            {
+                return NativeApi.RingPoolTryBulkEnqueue(_handle, ring, pointer, span.Length);
+            }
+        }
+
+        public bool TryBulkDequeue(long ring, Span<byte> span)
+        {
+            fixed (byte* pointer = span)
+            {
+                return NativeApi.RingPoolTryBulkDequeue(_handle, ring, pointer, span.Length);
+            }
+        }
+    }
+
+    internal sealed class RingPoolHandle : SafeHandle
+    {
+        public override bool IsInvalid => IntPtr.Zero == handle;
+
+        private RingPoolHandle() : base(invalidHandleValue: IntPtr.Zero, ownsHandle: true)
+        {
+        }
+
+        protected override bool ReleaseHandle()
+        {
+            NativeApi.ReleaseRingPool(handle);
+#if DEVELOPMENT_BUILD
+            Console.WriteLine($"RingPoolHandle.ReleaseHandle");
+#endif
+            return true;
+        }
+    }
+}
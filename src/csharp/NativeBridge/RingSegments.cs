@@ -0,0 +1,59 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+using System;
+
+namespace SignalScatter.NativeBridge
+{
+    /// <summary>
+    /// Readable bytes of a ring exposed in place as up to two spans over native memory (the second one
+    /// is non-empty when the data wraps around the end of the storage).
+    /// </summary>
+    public readonly unsafe ref struct ReadSegments
+    {
+        public readonly ReadOnlySpan<byte> First;
+        public readonly ReadOnlySpan<byte> Second;
+        public readonly int Token;
+
+        public int Length => First.Length + Second.Length;
+        public bool IsEmpty => Length == 0;
+
+        internal ReadSegments(ByteSpan first, ByteSpan second, int token)
+        {
+            First = new ReadOnlySpan<byte>(first.Pointer, first.Length);
+            Second = new ReadOnlySpan<byte>(second.Pointer, second.Length);
+            Token = token;
+        }
+    }
+
+    /// <summary>
+    /// Reserved free bytes of a ring exposed in place as up to two writable spans over native memory.
+    /// </summary>
+    public readonly unsafe ref struct WriteSegments
+    {
+        public readonly Span<byte> First;
+        public readonly Span<byte> Second;
+        public readonly int Token;
+
+        public int Length => First.Length + Second.Length;
+
+        internal WriteSegments(ByteSpan first, ByteSpan second, int token)
+        {
+            First = new Span<byte>(first.Pointer, first.Length);
+            Second = new Span<byte>(second.Pointer, second.Length);
+            Token = token;
+        }
+
+        /// <summary>
+        /// Copies data into the reservation starting at offset, continuing into the second span as needed.
+        /// </summary>
+        public void Write(int offset, ReadOnlySpan<byte> data)
+        {
+            if (offset < 0 || offset + data.Length > Length) { throw new ArgumentOutOfRangeException(nameof(offset)); }
+
+            int firstLength = Math.Max(0, Math.Min(data.Length, First.Length - offset));
+            if (firstLength > 0) { data.Slice(0, firstLength).CopyTo(First.Slice(offset)); }
+            if (firstLength < data.Length) { data.Slice(firstLength).CopyTo(Second.Slice(offset + firstLength - First.Length)); }
+        }
+    }
+}
@@ -0,0 +1,104 @@
+// Copyright (c) 2022 Soichiro Sugimoto
+// Licensed under the MIT License.
+
+using System;
+using System.Runtime.InteropServices;
+
+namespace SignalScatter.NativeBridge
+{
+    public sealed unsafe class ScatterEngine : IDisposable
+    {
+        public uint DroppedCount => NativeApi.ScatterEngineGetDroppedCount(_handle);
+
+        public bool IsInvalid => _handle.IsInvalid;
+
+        private readonly ScatterEngineHandle _handle;
+        private readonly uint _pointCount;
+
+        public ScatterEngine(uint pointCount, int inboxCapacity, uint arenaSize, uint maxMessageCount)
+        {
+            _pointCount = pointCount;
+            _handle = NativeApi.CreateScatterEngine(pointCount, inboxCapacity, arenaSize, maxMessageCount);
+        }
+
+        public void Dispose() => _handle.Dispose();
+
+        public bool Publish(uint source, ReadOnlySpan<byte> payload)
+        {
+            bool published = false;
+
+            fixed (byte* pointer = payload)
+            {
+                published = NativeApi.ScatterEnginePublish(_handle, source, pointer, payload.Length);
+            }
+
+            return published;
+        }
+
+        public uint Scatter(uint k, ReadOnlySpan<uint> neighborIdMatrix)
+        {
+            // The native side reads pointCount x k IDs.
+            if (neighborIdMatrix.Length < (long)_pointCount * k) { throw new ArgumentOutOfRangeException(nameof(neighborIdMatrix)); }
+
+            fixed (uint* ids = neighborIdMatrix)
+            {
+                return NativeApi.ScatterEngineScatter(_handle, k, ids);
+            }
+        }
+
+        public uint Scatter(ReadOnlySpan<uint> neighborOffsets, ReadOnlySpan<uint> neighborIds)
+        {
+            // The native side reads pointCount + 1 offsets and every row they delimit.
+            if (neighborOffsets.Length < (long)_pointCount + 1) { throw new ArgumentOutOfRangeException(nameof(neighborOffsets)); }
+            for (int i = 0; i < (int)_pointCount; i++)
+            {
+                if (neighborOffsets[i] > neighborOffsets[i + 1]) { throw new ArgumentOutOfRangeException(nameof(neighborOffsets)); }
+            }
+            if (neighborIds.Length < neighborOffsets[(int)_pointCount]) { throw new ArgumentOutOfRangeException(nameof(neighborIds)); }
+
+            fixed (uint* offsets = neighborOffsets)
+            fixed (uint* ids = neighborIds)
+            {
+                return NativeApi.ScatterEngineScatterCsr(_handle, offsets, ids);
+            }
+        }
+
+        /// <summary>
+        /// The payload points into native memory and stays valid until ResetFrame.
+        /// </summary>
+        public bool TryReceive(uint point, out ReadOnlySpan<byte> payload)
+        {
+            byte* pointer = null;
+            int length = 0;
+
+            if (!NativeApi.ScatterEngineTryReceive(_handle, point, &pointer, &length))
+            {
+                payload = ReadOnlySpan<byte>.Empty;
+                return false;
+            }
+
+            payload = new ReadOnlySpan<byte>(pointer, length);
+            return true;
+        }
+
+        public void ResetFrame() => NativeApi.ScatterEngineResetFrame(_handle);
+    }
+
+    internal sealed class ScatterEngineHandle : SafeHandle
+    {
+        public override bool IsInvalid => IntPtr.Zero == handle;
+
+        private ScatterEngineHandle() : base(invalidHandleValue: IntPtr.Zero, ownsHandle: true)
+        {
+        }
+
+        protected override bool ReleaseHandle()
+        {
+            NativeApi.ReleaseScatterEngine(handle);
+#if DEVELOPMENT_BUILD
+            Console.WriteLine($"ScatterEngineHandle.ReleaseHandle");
+#endif
+            return true;
+        }
+    }
+}